@@ -2,6 +2,9 @@
 
 #include "core/physical_device.h"
 #include "core/instance.h"
+#include "core/pipeline_cache.h"
+#include "graphics/shader_library.h"
+#include "resources/descriptors/descriptor_set_layout_cache.h"
 
 #include <set>
 #include <vector>
@@ -10,7 +13,7 @@
 namespace vkcommon
 {
 
-    Device::Device(const PhysicalDevice& physicalDevice)
+    Device::Device(const PhysicalDevice& physicalDevice, const std::filesystem::path& pipelineCachePath)
         : m_physicalDeviceRef(physicalDevice)
     {
         QueueFamilyIndices indices = m_physicalDeviceRef.queueFamilyIndices();
@@ -19,6 +22,10 @@ namespace vkcommon
         std::set<uint32_t> uniqueQueueFamilies = {
             indices.graphicsFamily.value(),
             indices.presentFamily.value() };
+        if (indices.transferFamily.has_value())
+        {
+            uniqueQueueFamilies.insert(indices.transferFamily.value());
+        }
 
         float queuePriority = 1.0f;
         for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -31,13 +38,41 @@ namespace vkcommon
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        const VkPhysicalDeviceFeatures& supportedFeatures = m_physicalDeviceRef.features();
+
         VkPhysicalDeviceFeatures deviceFeatures{};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
         deviceFeatures.sampleRateShading = VK_TRUE;
         deviceFeatures.geometryShader = VK_TRUE;
+        // Wireframe pipeline variants
+        deviceFeatures.fillModeNonSolid = supportedFeatures.fillModeNonSolid;
+        // Indirect draws, without them callers fall back to one draw per command
+        deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+        deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+        m_enabledFeatures = deviceFeatures;
+
+        // GPU culling writes its own draw count, without it culling runs on the CPU
+        VkPhysicalDeviceVulkan12Features features12{};
+        features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        const VkPhysicalDeviceVulkan12Features& supportedFeatures12 = m_physicalDeviceRef.features12();
+        features12.drawIndirectCount = supportedFeatures12.drawIndirectCount;
+        // Bindless texture tables, all or nothing
+        VkBool32 bindless = (
+            supportedFeatures12.runtimeDescriptorArray &&
+            supportedFeatures12.shaderSampledImageArrayNonUniformIndexing &&
+            supportedFeatures12.descriptorBindingPartiallyBound &&
+            supportedFeatures12.descriptorBindingSampledImageUpdateAfterBind &&
+            supportedFeatures12.descriptorBindingUpdateUnusedWhilePending) ? VK_TRUE : VK_FALSE;
+        features12.runtimeDescriptorArray = bindless;
+        features12.shaderSampledImageArrayNonUniformIndexing = bindless;
+        features12.descriptorBindingPartiallyBound = bindless;
+        features12.descriptorBindingSampledImageUpdateAfterBind = bindless;
+        features12.descriptorBindingUpdateUnusedWhilePending = bindless;
+        m_enabledFeatures12 = features12;
 
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = &features12;
         createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
@@ -64,16 +99,33 @@ namespace vkcommon
         // in order to use it later
         vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
         vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
+
+        m_graphicsFamily = indices.graphicsFamily.value();
+        m_transferFamily = indices.transferFamily.value_or(m_graphicsFamily);
+        vkGetDeviceQueue(m_device, m_transferFamily, 0, &m_transferQueue);
+
+        m_pipelineCache = std::make_unique<PipelineCache>(*this, pipelineCachePath);
+        m_shaderLibrary = std::make_unique<ShaderLibrary>(*this);
+        m_descriptorSetLayoutCache = std::make_unique<DescriptorSetLayoutCache>(*this);
     }
 
     Device::~Device()
     {
         if (m_device != VK_NULL_HANDLE)
         {
+            // Writes the cache back to disk, needs the device alive
+            m_pipelineCache.reset();
+            m_shaderLibrary.reset();
+            m_descriptorSetLayoutCache.reset();
             vkDestroyDevice(m_device, nullptr);
         }
     }
 
+    VkPipelineCache Device::pipelineCache() const
+    {
+        return m_pipelineCache->handle();
+    }
+
     VkFormatProperties Device::physicalDeviceFormatProperties(VkFormat format) const
     {
         VkFormatProperties formatProperties;
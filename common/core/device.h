@@ -3,14 +3,22 @@
 
 #include <vulkan/vulkan.h>
 
+#include <filesystem>
+#include <memory>
+
 namespace vkcommon
 {
     class PhysicalDevice;
+    class PipelineCache;
+    class ShaderLibrary;
+    class DescriptorSetLayoutCache;
 
     class Device
     {
     public:
-        Device(const PhysicalDevice& physicalDevice);
+        // The pipeline cache is loaded from and saved back to pipelineCachePath
+        Device(const PhysicalDevice& physicalDevice,
+            const std::filesystem::path& pipelineCachePath = "pipeline_cache.bin");
         ~Device();
 
         Device(const Device&) = delete;
@@ -19,16 +27,40 @@ namespace vkcommon
         VkDevice handle() const { return m_device; }
         VkQueue graphicsQueue() const { return m_graphicsQueue; }
         VkQueue presentQueue() const { return m_presentQueue; }
+        // Falls back to the graphics queue when there is no transfer-only family
+        VkQueue transferQueue() const { return m_transferQueue; }
+        uint32_t graphicsQueueFamily() const { return m_graphicsFamily; }
+        uint32_t transferQueueFamily() const { return m_transferFamily; }
+        bool hasDedicatedTransferQueue() const { return m_transferFamily != m_graphicsFamily; }
+        // Optional features, enabled when the physical device supports them
+        const VkPhysicalDeviceFeatures& enabledFeatures() const { return m_enabledFeatures; }
+        const VkPhysicalDeviceVulkan12Features& enabledFeatures12() const { return m_enabledFeatures12; }
+        // Descriptor indexing features a BindlessTextureTable needs
+        bool supportsBindlessTextures() const { return m_enabledFeatures12.runtimeDescriptorArray == VK_TRUE; }
 
         VkFormatProperties physicalDeviceFormatProperties(VkFormat format) const;
         VkFormat findDepthFormat() const;
         VkSampleCountFlagBits msaaSamples() const;
         const PhysicalDevice& physicalDevice() const { return m_physicalDeviceRef; }
+        // Shared by every pipeline created on this device
+        VkPipelineCache pipelineCache() const;
+        // Shader modules shared by every pipeline created on this device
+        ShaderLibrary& shaderLibrary() const { return *m_shaderLibrary; }
+        // One layout per distinct binding list, shared across the device
+        DescriptorSetLayoutCache& descriptorSetLayoutCache() const { return *m_descriptorSetLayoutCache; }
 
     private:
         VkDevice m_device = VK_NULL_HANDLE;
         VkQueue m_graphicsQueue;
         VkQueue m_presentQueue;
+        VkQueue m_transferQueue;
+        uint32_t m_graphicsFamily{ 0 };
+        uint32_t m_transferFamily{ 0 };
+        VkPhysicalDeviceFeatures m_enabledFeatures{};
+        VkPhysicalDeviceVulkan12Features m_enabledFeatures12{};
+        std::unique_ptr<PipelineCache> m_pipelineCache;
+        std::unique_ptr<ShaderLibrary> m_shaderLibrary;
+        std::unique_ptr<DescriptorSetLayoutCache> m_descriptorSetLayoutCache;
 
         const PhysicalDevice& m_physicalDeviceRef;
     };
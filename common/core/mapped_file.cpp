@@ -0,0 +1,105 @@
+#include "mapped_file.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define VKCOMMON_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vkcommon
+{
+
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+#ifdef VKCOMMON_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Failed to open file: " + path.string());
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat file: " + path.string());
+        }
+
+        m_size = static_cast<size_t>(info.st_size);
+        if (m_size > 0)
+        {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("Failed to map file: " + path.string());
+            }
+            m_data = data;
+            m_mapped = true;
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::ate | std::ios::binary);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open file: " + path.string());
+        }
+
+        m_size = static_cast<size_t>(file.tellg());
+        m_buffer.resize((m_size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_size));
+        m_data = m_buffer.data();
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_mapped(std::exchange(other.m_mapped, false)),
+        m_buffer(std::move(other.m_buffer))
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_mapped = std::exchange(other.m_mapped, false);
+            m_buffer = std::move(other.m_buffer);
+        }
+        return *this;
+    }
+
+    void MappedFile::unmap() noexcept
+    {
+#ifdef VKCOMMON_HAS_MMAP
+        if (m_mapped)
+        {
+            ::munmap(const_cast<void*>(m_data), m_size);
+            m_mapped = false;
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_buffer.clear();
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,44 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace vkcommon
+{
+    // Read-only view of a whole file. Mapped into memory where the platform
+    // supports it, read into a word-aligned buffer otherwise; either way
+    // data() is suitably aligned for SPIR-V words.
+    class MappedFile
+    {
+    public:
+        // Throws if the file cannot be opened or mapped
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        const void* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+        const uint32_t* words() const { return static_cast<const uint32_t*>(m_data); }
+        size_t wordCount() const { return m_size / sizeof(uint32_t); }
+
+    private:
+        void unmap() noexcept;
+
+        const void* m_data{ nullptr };
+        size_t m_size{ 0 };
+        bool m_mapped{ false };
+        std::vector<uint32_t> m_buffer;
+    };
+
+} // namespace vkcommon
+
+#endif // MAPPED_FILE_H
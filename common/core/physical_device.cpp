@@ -31,6 +31,17 @@ namespace vkcommon
             {
                 m_physicalDevice = device;
                 m_indices = findQueueFamilies(device);
+                vkGetPhysicalDeviceProperties(device, &m_properties);
+                vkGetPhysicalDeviceFeatures(device, &m_features);
+
+                // Core 1.2 features, e.g. drawIndirectCount
+                m_features12 = {};
+                m_features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+                VkPhysicalDeviceFeatures2 features2{};
+                features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features2.pNext = &m_features12;
+                vkGetPhysicalDeviceFeatures2(device, &features2);
+                m_features12.pNext = nullptr;
                 m_msaaSamples = getMaxUsableSampleCount();
                 break;
             }
@@ -68,11 +79,11 @@ namespace vkcommon
         vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
         std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
         vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
-        int i = 0;
+        uint32_t i = 0;
         for (const auto& queueFamily : queueFamilies)
         {
             // graphics operations
-            if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            if (!indices.graphicsFamily.has_value() && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT))
             {
                 indices.graphicsFamily = i;
             }
@@ -80,15 +91,19 @@ namespace vkcommon
             // presentation (surface) support
             VkBool32 presentSupport = false;
             vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, m_surfaceRef.handle(), &presentSupport);
-            if (presentSupport)
+            if (!indices.presentFamily.has_value() && presentSupport)
             {
                 indices.presentFamily = i;
             }
 
-            if (!indices.isComplete())
+            // transfer without graphics or compute, so copies can run beside rendering
+            if (!indices.transferFamily.has_value() &&
+                (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                !(queueFamily.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
             {
-                break;
+                indices.transferFamily = i;
             }
+
             i++;
         }
         return indices;
@@ -114,10 +129,7 @@ namespace vkcommon
 
     VkSampleCountFlagBits PhysicalDevice::getMaxUsableSampleCount()
     {
-        VkPhysicalDeviceProperties physicalDeviceProperties;
-        vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
-
-        VkSampleCountFlags counts = physicalDeviceProperties.limits.framebufferColorSampleCounts & physicalDeviceProperties.limits.framebufferDepthSampleCounts;
+        VkSampleCountFlags counts = m_properties.limits.framebufferColorSampleCounts & m_properties.limits.framebufferDepthSampleCounts;
 
         if (counts & VK_SAMPLE_COUNT_64_BIT)
             return VK_SAMPLE_COUNT_64_BIT;
@@ -22,6 +22,8 @@ namespace vkcommon
         // std::optional is a wrapper that contains a value or nothing
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        // Transfer-only family (usually a DMA engine), empty if the device has none
+        std::optional<uint32_t> transferFamily;
 
         bool isComplete()
         {
@@ -41,6 +43,9 @@ namespace vkcommon
         VkPhysicalDevice handle() const { return m_physicalDevice; }
         VkSampleCountFlagBits msaaSamples() const { return m_msaaSamples; }
         QueueFamilyIndices queueFamilyIndices() const { return m_indices; }
+        const VkPhysicalDeviceProperties& properties() const { return m_properties; }
+        const VkPhysicalDeviceFeatures& features() const { return m_features; }
+        const VkPhysicalDeviceVulkan12Features& features12() const { return m_features12; }
 
         VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
         VkFormat findDepthFormat() const;
@@ -58,6 +63,9 @@ namespace vkcommon
 
         VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
         QueueFamilyIndices m_indices;
+        VkPhysicalDeviceProperties m_properties{};
+        VkPhysicalDeviceFeatures m_features{};
+        VkPhysicalDeviceVulkan12Features m_features12{};
         VkSampleCountFlagBits m_msaaSamples = VK_SAMPLE_COUNT_1_BIT;
     };
 } // namespace vkcommon
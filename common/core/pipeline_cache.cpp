@@ -0,0 +1,129 @@
+#include "pipeline_cache.h"
+
+#include "core/device.h"
+#include "core/physical_device.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace vkcommon
+{
+
+    namespace
+    {
+        // Layout of VkPipelineCacheHeaderVersionOne at the start of every blob
+        struct CacheHeader
+        {
+            uint32_t headerSize;
+            uint32_t headerVersion;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        };
+    }
+
+    PipelineCache::PipelineCache(const Device& device, const std::filesystem::path& path)
+        : m_path(path), m_deviceRef(device)
+    {
+        std::vector<char> blob = readBlob();
+        m_loadedFromDisk = isCompatible(blob);
+        if (!m_loadedFromDisk)
+        {
+            blob.clear();
+        }
+
+        VkPipelineCacheCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = blob.size();
+        createInfo.pInitialData = blob.empty() ? nullptr : blob.data();
+
+        if (vkCreatePipelineCache(m_deviceRef.handle(), &createInfo, nullptr, &m_cache) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create pipeline cache!");
+        }
+    }
+
+    PipelineCache::~PipelineCache()
+    {
+        if (m_cache != VK_NULL_HANDLE)
+        {
+            save();
+            vkDestroyPipelineCache(m_deviceRef.handle(), m_cache, nullptr);
+        }
+    }
+
+    bool PipelineCache::save() const
+    {
+        size_t size = 0;
+        if (vkGetPipelineCacheData(m_deviceRef.handle(), m_cache, &size, nullptr) != VK_SUCCESS || size == 0)
+        {
+            return false;
+        }
+
+        std::vector<char> blob(size);
+        if (vkGetPipelineCacheData(m_deviceRef.handle(), m_cache, &size, blob.data()) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        // Write next to the target, then swap it in with a single rename
+        std::filesystem::path tempPath = m_path;
+        tempPath += ".tmp";
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.write(blob.data(), static_cast<std::streamsize>(size)) || !file.flush())
+            {
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, m_path, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<char> PipelineCache::readBlob() const
+    {
+        std::ifstream file(m_path, std::ios::ate | std::ios::binary);
+        if (!file.is_open())
+        {
+            return {};
+        }
+
+        std::vector<char> blob(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(blob.data(), static_cast<std::streamsize>(blob.size())))
+        {
+            return {};
+        }
+        return blob;
+    }
+
+    bool PipelineCache::isCompatible(const std::vector<char>& blob) const
+    {
+        if (blob.size() < sizeof(CacheHeader))
+        {
+            return false;
+        }
+
+        CacheHeader header;
+        std::memcpy(&header, blob.data(), sizeof(header));
+
+        const VkPhysicalDeviceProperties& properties = m_deviceRef.physicalDevice().properties();
+
+        return header.headerSize >= sizeof(CacheHeader)
+            && header.headerSize <= blob.size()
+            && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && header.vendorID == properties.vendorID
+            && header.deviceID == properties.deviceID
+            && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,47 @@
+#ifndef PIPELINE_CACHE_H
+#define PIPELINE_CACHE_H
+
+#include <vulkan/vulkan.h>
+
+#include <filesystem>
+#include <vector>
+
+namespace vkcommon
+{
+    class Device;
+
+    // VkPipelineCache persisted across runs. The blob on disk is only handed
+    // to the driver when its header matches this device (vendor, device and
+    // cache UUID); otherwise the cache starts empty. Written back on
+    // destruction through a temporary file that replaces the old one, so a
+    // crash mid-write never leaves a truncated cache behind.
+    class PipelineCache
+    {
+    public:
+        PipelineCache(const Device& device, const std::filesystem::path& path);
+        ~PipelineCache();
+
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        // Returns false if the data could not be written; never throws
+        bool save() const;
+
+        VkPipelineCache handle() const { return m_cache; }
+        // Whether a compatible blob was loaded from disk
+        bool loadedFromDisk() const { return m_loadedFromDisk; }
+
+    private:
+        std::vector<char> readBlob() const;
+        bool isCompatible(const std::vector<char>& blob) const;
+
+        VkPipelineCache m_cache = VK_NULL_HANDLE;
+        std::filesystem::path m_path;
+        bool m_loadedFromDisk{ false };
+
+        const Device& m_deviceRef;
+    };
+
+} // namespace vkcommon
+
+#endif // PIPELINE_CACHE_H
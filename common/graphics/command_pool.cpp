@@ -2,19 +2,25 @@
 
 #include "core/device.h"
 #include "core/physical_device.h"
+#include "sync/fence.h"
 
 #include <stdexcept>
 
 namespace vkcommon
 {
     CommandPool::CommandPool(const PhysicalDevice& physicalDevice, const Device& device)
+        : CommandPool(device, physicalDevice.queueFamilyIndices().graphicsFamily.value())
+    {
+    }
+
+    CommandPool::CommandPool(const Device& device, uint32_t queueFamilyIndex, VkCommandPoolCreateFlags flags)
         : m_deviceRef(device)
     {
 
         VkCommandPoolCreateInfo commandPoolCreateInfo{};
         commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-        commandPoolCreateInfo.queueFamilyIndex = physicalDevice.queueFamilyIndices().graphicsFamily.value();
+        commandPoolCreateInfo.flags = flags;
+        commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
 
         if (vkCreateCommandPool(device.handle(), &commandPoolCreateInfo, nullptr, &m_commandPool) != VK_SUCCESS)
         {
@@ -72,6 +78,30 @@ namespace vkcommon
         return commandBuffer;
     }
 
+    VkCommandBuffer CommandPool::beginSecondaryCommandBuffer(VkCommandBuffer commandBuffer,
+        VkRenderPass renderPass,
+        uint32_t subpass,
+        VkFramebuffer framebuffer,
+        VkCommandBufferUsageFlags flags) const
+    {
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = renderPass;
+        inheritanceInfo.subpass = subpass;
+        inheritanceInfo.framebuffer = framebuffer;
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = flags | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to begin recording secondary command buffer!");
+        }
+
+        return commandBuffer;
+    }
+
     void CommandPool::endCommandBuffer(VkCommandBuffer commandBuffer) const
     {
         if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
@@ -79,6 +109,13 @@ namespace vkcommon
         }
     }
 
+    void CommandPool::reset() const
+    {
+        if (vkResetCommandPool(m_deviceRef.handle(), m_commandPool, 0) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to reset command pool!");
+        }
+    }
+
     VkCommandBuffer CommandPool::beginSingleTimeCommand() const
     {
         
@@ -98,8 +135,12 @@ namespace vkcommon
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &commandBuffer;
 
-        vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(queue);
+        // Wait on this submission only instead of draining the whole queue
+        Fence fence{ m_deviceRef, false };
+        if (vkQueueSubmit(queue, 1, &submitInfo, fence.handle()) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit single time command buffer!");
+        }
+        fence.wait();
 
         freeSingleBuffer(commandBuffer);
     }
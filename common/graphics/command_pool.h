@@ -13,6 +13,10 @@ namespace vkcommon
     {
     public:
         CommandPool(const PhysicalDevice& PhysicalDevice, const Device& device);
+        // Pool for a specific queue family, e.g. the transfer queue. Pools that
+        // are only reset as a whole can pass TRANSIENT_BIT instead.
+        CommandPool(const Device& device, uint32_t queueFamilyIndex,
+            VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
         ~CommandPool();
 
         CommandPool(const CommandPool&) = delete;
@@ -26,8 +30,19 @@ namespace vkcommon
 
         // Begin and end single time command buffer
         VkCommandBuffer beginCommandBuffer(VkCommandBuffer commandBuffer, VkCommandBufferUsageFlags flags) const;
+        // Secondary buffer continuing subpass of renderPass, executed from a
+        // primary that began the pass with SECONDARY_COMMAND_BUFFERS contents
+        VkCommandBuffer beginSecondaryCommandBuffer(VkCommandBuffer commandBuffer,
+            VkRenderPass renderPass,
+            uint32_t subpass,
+            VkFramebuffer framebuffer = VK_NULL_HANDLE,
+            VkCommandBufferUsageFlags flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT) const;
         void endCommandBuffer(VkCommandBuffer commandBuffer) const;
 
+        // Returns every buffer of the pool to the initial state at once; none
+        // may be pending on the GPU
+        void reset() const;
+
         // Immediate command execution
         VkCommandBuffer beginSingleTimeCommand() const;
         void endSingleTimeCommand(VkCommandBuffer commandBuffer, VkQueue queue) const;
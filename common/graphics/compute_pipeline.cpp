@@ -0,0 +1,115 @@
+#include "compute_pipeline.h"
+
+#include "core/device.h"
+#include "graphics/shader_module.h"
+#include "graphics/shader_library.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace vkcommon
+{
+
+    ComputePipeline::ComputePipeline(
+        const Device& device,
+        const std::vector<VkDescriptorSetLayout>& descriptorLayout,
+        const std::filesystem::path& compPath)
+        : m_shaderPath(compPath), m_deviceRef(device)
+    {
+        m_shaderModule = device.shaderLibrary().load(compPath);
+
+        createPipelineLayout(descriptorLayout, m_shaderModule->reflection());
+
+        try
+        {
+            m_computePipeline = createPipeline(*m_shaderModule);
+        }
+        catch (...)
+        {
+            vkDestroyPipelineLayout(m_deviceRef.handle(), m_pipelineLayout, nullptr);
+            throw;
+        }
+    }
+
+    ComputePipeline::~ComputePipeline()
+    {
+        vkDestroyPipeline(m_deviceRef.handle(), m_computePipeline, nullptr);
+        vkDestroyPipelineLayout(m_deviceRef.handle(), m_pipelineLayout, nullptr);
+    }
+
+    void ComputePipeline::createPipelineLayout(const std::vector<VkDescriptorSetLayout>& descriptorLayout,
+        const ShaderReflection& reflection)
+    {
+        const std::vector<VkPushConstantRange>& pushConstantRanges = reflection.pushConstantRanges();
+
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorLayout.size());
+        layoutInfo.pSetLayouts = descriptorLayout.data();
+        layoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+        layoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+        if (vkCreatePipelineLayout(m_deviceRef.handle(), &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create pipeline layout!");
+        }
+    }
+
+    VkPipeline ComputePipeline::createPipeline(const ShaderModule& shaderModule) const
+    {
+        VkPipelineShaderStageCreateInfo shaderStage{};
+        shaderStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        shaderStage.module = shaderModule;
+        shaderStage.pName = "main";
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage = shaderStage;
+        pipelineInfo.layout = m_pipelineLayout;
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        if (vkCreateComputePipelines(m_deviceRef.handle(), m_deviceRef.pipelineCache(), 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create compute pipeline!");
+        }
+        return pipeline;
+    }
+
+    VkPipeline ComputePipeline::reloadShaders(const std::vector<std::filesystem::path>& changedPaths)
+    {
+        std::string key = ShaderLibrary::pathKey(m_shaderPath);
+        bool listed = std::any_of(changedPaths.begin(), changedPaths.end(), [&key](const std::filesystem::path& path) {
+            return ShaderLibrary::pathKey(path) == key;
+        });
+        if (!listed)
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        std::shared_ptr<const ShaderModule> shaderModule = m_deviceRef.shaderLibrary().reload(m_shaderPath);
+        if (shaderModule == m_shaderModule)
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        if (!shaderModule->reflection().hasSameLayout(m_shaderModule->reflection()))
+        {
+            throw std::runtime_error("Failed to reload shaders: descriptor bindings or push constants changed!");
+        }
+
+        VkPipeline pipeline = createPipeline(*shaderModule);
+        m_shaderModule = std::move(shaderModule);
+
+        VkPipeline replaced = m_computePipeline;
+        m_computePipeline = pipeline;
+        return replaced;
+    }
+
+    void ComputePipeline::bind(VkCommandBuffer commandBuffer) const
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_computePipeline);
+    }
+
+} // namespace vkcommon
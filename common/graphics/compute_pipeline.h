@@ -0,0 +1,62 @@
+#ifndef COMPUTE_PIPELINE_H
+#define COMPUTE_PIPELINE_H
+
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include <filesystem>
+
+#include "graphics/push_constants.h"
+
+namespace vkcommon
+{
+
+    class Device;
+    class ShaderReflection;
+    class ShaderModule;
+
+    class ComputePipeline
+    {
+    public:
+        ComputePipeline(
+            const Device& device,
+            const std::vector<VkDescriptorSetLayout>& descriptorLayout,
+            const std::filesystem::path& compPath
+            );
+
+        ~ComputePipeline();
+
+        ComputePipeline(const ComputePipeline&) = delete;
+        ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+        void bind(VkCommandBuffer commandBuffer) const;
+
+        template <typename T>
+        void pushConstants(VkCommandBuffer commandBuffer, const T& data, uint32_t offset = 0) const
+        {
+            vkcommon::pushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, data, offset);
+        }
+
+        // Same contract as GraphicsPipeline::reloadShaders
+        VkPipeline reloadShaders(const std::vector<std::filesystem::path>& changedPaths);
+
+        VkPipeline handle() const { return m_computePipeline; }
+        VkPipelineLayout layout() const { return m_pipelineLayout; }
+
+    private:
+        // Push constant ranges come from the shader's reflection
+        void createPipelineLayout(const std::vector<VkDescriptorSetLayout>& descriptorLayout,
+            const ShaderReflection& reflection);
+        VkPipeline createPipeline(const ShaderModule& shaderModule) const;
+
+        VkPipelineLayout m_pipelineLayout{ VK_NULL_HANDLE };
+        VkPipeline m_computePipeline{ VK_NULL_HANDLE };
+        std::shared_ptr<const ShaderModule> m_shaderModule;
+        std::filesystem::path m_shaderPath;
+
+        const Device& m_deviceRef;
+    };
+
+} // namespace vkcommon
+#endif // COMPUTE_PIPELINE_H
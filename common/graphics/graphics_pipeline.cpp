@@ -2,12 +2,20 @@
 
 #include "core/device.h"
 #include "graphics/shader_module.h"
+#include "graphics/shader_library.h"
 #include "graphics/render_pass.h"
 #include "graphics/pipeline_builder.h"
+#include "graphics/pipeline_registry.h"
+#include "graphics/pipeline_compiler.h"
 #include "graphics/swap_chain.h"
 #include "resources/buffers/vertex_buffer.h"
+#include "resources/descriptors/descriptor_set_layout.h"
+#include "resources/descriptors/descriptor_set_layout_cache.h"
 
+#include <algorithm>
 #include <fstream>
+#include <stdexcept>
+#include <string>
 
 namespace vkcommon
 {
@@ -19,35 +27,31 @@ namespace vkcommon
         const std::filesystem::path& vertPath,
         const std::filesystem::path& fragPath,
         const std::filesystem::path& geomPath)
-        : m_deviceRef(device), m_swapChainRef(swapChain), m_renderPass(device, swapChain)
+        : m_deviceRef(device), m_swapChainRef(swapChain), m_renderPass(device, swapChain), m_builder(device)
     {
         // Create shader modules
-        std::vector<ShaderModule> shaderModules;
-        shaderModules.reserve(3); // 0 : Vertex, 1 : Fragment, and 2 : Geometry shaders
-
-        shaderModules.emplace_back(device, vertPath);
-        shaderModules.emplace_back(device, fragPath);
-
-        std::vector<VkPipelineShaderStageCreateInfo> shaderStages = {
-            {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_VERTEX_BIT, shaderModules[0], "main"},
-            {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_FRAGMENT_BIT, shaderModules[1], "main"}
-        };
+        m_shaderModules.reserve(3); // 0 : Vertex, 1 : Fragment, and 2 : Geometry shaders
 
+        m_shaderPaths = { vertPath, fragPath };
         if (!geomPath.empty())
         {
-            shaderModules.emplace_back(device, geomPath);
-            shaderStages.push_back(
-                { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_GEOMETRY_BIT, shaderModules[2], "main"}
-            );
+            m_shaderPaths.push_back(geomPath);
+        }
+
+        ShaderLibrary& library = device.shaderLibrary();
+        for (const auto& path : m_shaderPaths)
+        {
+            m_shaderModules.push_back(library.load(path));
+            m_reflection.merge(m_shaderModules.back()->reflection());
         }
+        validateVertexInput(m_reflection);
 
         // Create pipeline layout
         createPipelineLayout(descriptorLayout);
 
         // Set up pipeline builder
-        PipelineBuilder builder(device);
-        builder
-            .setShaderStages(shaderStages)
+        m_builder
+            .setShaderStages(shaderStages(m_shaderModules))
             .setVertexInput(Vertex::getBindingDescription(), Vertex::getAttributeDescriptions())
             .setInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
             .setViewport()
@@ -59,21 +63,43 @@ namespace vkcommon
             .setPipelineLayout(m_pipelineLayout);
 
         // Build the pipeline
-        m_graphicsPipeline = builder.build(m_renderPass);
+        m_graphicsPipeline = m_builder.build(m_renderPass);
     }
 
     GraphicsPipeline::~GraphicsPipeline()
     {
+        // Variants reference the layout destroyed below and modules the library may trim
+        if (m_registry)
+        {
+            m_registry->release(m_pipelineLayout);
+        }
+
         vkDestroyPipeline(m_deviceRef.handle(), m_graphicsPipeline, nullptr);
         vkDestroyPipelineLayout(m_deviceRef.handle(), m_pipelineLayout, nullptr);
     }
 
     void GraphicsPipeline::createPipelineLayout(const std::vector<VkDescriptorSetLayout>& descriptorLayout)
     {
+        std::vector<VkDescriptorSetLayout> setLayouts = descriptorLayout;
+        if (setLayouts.empty())
+        {
+            // Unused sets below the highest one get an empty layout. Layouts
+            // come from the device cache and outlive the pipeline.
+            for (uint32_t set = 0; set < m_reflection.setCount(); set++)
+            {
+                DescriptorSetLayoutCache& layoutCache = m_deviceRef.descriptorSetLayoutCache();
+                setLayouts.push_back(layoutCache.get(m_reflection.layoutBindings(set)).handle());
+            }
+        }
+
+        const std::vector<VkPushConstantRange>& pushConstantRanges = m_reflection.pushConstantRanges();
+
         VkPipelineLayoutCreateInfo layoutInfo{};
         layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        layoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorLayout.size());
-        layoutInfo.pSetLayouts = descriptorLayout.data();
+        layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+        layoutInfo.pSetLayouts = setLayouts.data();
+        layoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+        layoutInfo.pPushConstantRanges = pushConstantRanges.data();
 
         if (vkCreatePipelineLayout(m_deviceRef.handle(), &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
         {
@@ -81,11 +107,44 @@ namespace vkcommon
         }
     }
 
+    std::vector<VkPipelineShaderStageCreateInfo> GraphicsPipeline::shaderStages(
+        const std::vector<std::shared_ptr<const ShaderModule>>& shaderModules)
+    {
+        // 0 : Vertex, 1 : Fragment, and 2 : Geometry shaders
+        const VkShaderStageFlagBits stageBits[] = {
+            VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_GEOMETRY_BIT
+        };
+
+        std::vector<VkPipelineShaderStageCreateInfo> stages;
+        for (size_t i = 0; i < shaderModules.size(); i++)
+        {
+            VkPipelineShaderStageCreateInfo stage{};
+            stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stage.stage = stageBits[i];
+            stage.module = *shaderModules[i];
+            stage.pName = "main";
+            stages.push_back(stage);
+        }
+        return stages;
+    }
+
+    void GraphicsPipeline::validateVertexInput(const ShaderReflection& reflection)
+    {
+        const auto attributes = Vertex::getAttributeDescriptions();
+        reflection.validateVertexInput({ attributes.begin(), attributes.end() });
+    }
+
     void GraphicsPipeline::bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint) const
     {
         vkCmdBindPipeline(commandBuffer, bindPoint, m_graphicsPipeline);
     }
 
+    VkShaderStageFlags GraphicsPipeline::pushConstantStages() const
+    {
+        const std::vector<VkPushConstantRange>& ranges = m_reflection.pushConstantRanges();
+        return ranges.empty() ? 0 : ranges.front().stageFlags;
+    }
+
     void GraphicsPipeline::setViewportState(VkCommandBuffer commandBuffer, const VkExtent2D& extent)
     {
         VkViewport viewport{};
@@ -103,4 +162,120 @@ namespace vkcommon
         vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
     }
 
+    VkPipeline GraphicsPipeline::reloadShaders(const std::vector<std::filesystem::path>& changedPaths)
+    {
+        ShaderLibrary& library = m_deviceRef.shaderLibrary();
+
+        std::vector<std::string> changedKeys;
+        for (const auto& path : changedPaths)
+        {
+            changedKeys.push_back(ShaderLibrary::pathKey(path));
+        }
+
+        std::vector<std::shared_ptr<const ShaderModule>> shaderModules = m_shaderModules;
+        bool changed = false;
+        for (size_t i = 0; i < m_shaderPaths.size(); i++)
+        {
+            if (std::find(changedKeys.begin(), changedKeys.end(), ShaderLibrary::pathKey(m_shaderPaths[i])) != changedKeys.end())
+            {
+                shaderModules[i] = library.reload(m_shaderPaths[i]);
+                // Same code comes back as the same module
+                changed |= shaderModules[i] != m_shaderModules[i];
+            }
+        }
+
+        if (!changed)
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        ShaderReflection reflection;
+        for (const auto& shaderModule : shaderModules)
+        {
+            reflection.merge(shaderModule->reflection());
+        }
+        validateVertexInput(reflection);
+
+        if (!reflection.hasSameLayout(m_reflection))
+        {
+            throw std::runtime_error("Failed to reload shaders: descriptor bindings or push constants changed!");
+        }
+
+        // Build first, so a failure leaves this pipeline as it was
+        const std::vector<VkPipelineShaderStageCreateInfo> stages = shaderStages(shaderModules);
+        PipelineBuilder builder = m_builder;
+        builder.setShaderStages(stages);
+        VkPipeline pipeline = builder.build(m_renderPass);
+
+        m_builder.setShaderStages(stages);
+        if (m_registry)
+        {
+            for (size_t i = 0; i < m_shaderModules.size(); i++)
+            {
+                if (shaderModules[i] != m_shaderModules[i])
+                {
+                    m_staleShaderModules.push_back(m_shaderModules[i]);
+                }
+            }
+        }
+        m_shaderModules = std::move(shaderModules);
+        m_reflection = std::move(reflection);
+
+        VkPipeline replaced = m_graphicsPipeline;
+        m_graphicsPipeline = pipeline;
+        return replaced;
+    }
+
+    std::vector<VkPipeline> GraphicsPipeline::evictStaleVariants()
+    {
+        if (!m_registry || m_staleShaderModules.empty())
+        {
+            return {};
+        }
+
+        std::vector<VkShaderModule> staleModules;
+        for (const auto& shaderModule : m_staleShaderModules)
+        {
+            staleModules.push_back(*shaderModule);
+        }
+
+        std::vector<VkPipeline> stale = m_registry->evict(staleModules);
+        m_staleShaderModules.clear();
+        return stale;
+    }
+
+    VkPipeline GraphicsPipeline::variant(PipelineRegistry& registry, const PipelineVariant& variant)
+    {
+        return registry.getOrCreate(variantBuilder(registry, variant), m_renderPass);
+    }
+
+    AsyncPipeline GraphicsPipeline::variantAsync(PipelineRegistry& registry, PipelineCompiler& compiler, const PipelineVariant& variant)
+    {
+        return AsyncPipeline(
+            registry.getOrCreateAsync(variantBuilder(registry, variant), m_renderPass, compiler),
+            m_graphicsPipeline);
+    }
+
+    PipelineBuilder GraphicsPipeline::variantBuilder(PipelineRegistry& registry, const PipelineVariant& variant)
+    {
+        if (m_registry && m_registry != &registry)
+        {
+            throw std::runtime_error("Failed to create pipeline variant: pipeline already uses another registry!");
+        }
+        if (variant.polygonMode != VK_POLYGON_MODE_FILL && !m_deviceRef.enabledFeatures().fillModeNonSolid)
+        {
+            throw std::runtime_error("Failed to create pipeline variant: fillModeNonSolid is not supported!");
+        }
+        m_registry = &registry;
+
+        PipelineBuilder builder = m_builder;
+        builder
+            .setInputAssembly(variant.topology)
+            .setRasterizer(variant.polygonMode)
+            .setDepthStencil(variant.depthTest, variant.depthWrite)
+            .setSpecialization(variant.specialization);
+
+        return builder;
+    }
+
 } // namespace vkcommon
\ No newline at end of file
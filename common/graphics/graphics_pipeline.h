@@ -1,6 +1,7 @@
 #ifndef GRAPHICS_PIPELINE_H
 #define GRAPHICS_PIPELINE_H
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -8,6 +9,10 @@
 #include <filesystem>
 
 #include "graphics/render_pass.h"
+#include "graphics/shader_module.h"
+#include "graphics/pipeline_builder.h"
+#include "graphics/specialization_constants.h"
+#include "graphics/push_constants.h"
 
 namespace vkcommon
 {
@@ -15,10 +20,27 @@ namespace vkcommon
     class Device;
     class SwapChain;
     class RenderPass;
+    class PipelineRegistry;
+    class PipelineCompiler;
+    class AsyncPipeline;
+
+    // State a material may change on top of a GraphicsPipeline
+    struct PipelineVariant
+    {
+        VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;   // LINE needs fillModeNonSolid
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        bool depthTest = true;
+        bool depthWrite = true;
+        // Applied to every stage, e.g. material features compiled into the shaders
+        SpecializationConstants specialization;
+    };
 
     class GraphicsPipeline
     {
     public:
+        // descriptorLayout holds one layout per set; leave it empty to create
+        // them from the shaders' reflection. Push constant ranges always come
+        // from reflection.
         GraphicsPipeline(
             const Device& device,
             const SwapChain& swapChain,
@@ -34,12 +56,47 @@ namespace vkcommon
 
         void setViewportState(VkCommandBuffer commandBuffer, const VkExtent2D& extent);
 
+        // Pushes data with the stages that declare the push constant block
+        template <typename T>
+        void pushConstants(VkCommandBuffer commandBuffer, const T& data, uint32_t offset = 0) const
+        {
+            vkcommon::pushConstants(commandBuffer, m_pipelineLayout, pushConstantStages(), data, offset);
+        }
+        VkShaderStageFlags pushConstantStages() const;
+
+        // Same shaders, layout and render pass with variant's state applied,
+        // shared through registry with every other request for that state.
+        // Always use the same registry for one GraphicsPipeline.
+        VkPipeline variant(PipelineRegistry& registry, const PipelineVariant& variant);
+
+        // Compiles the variant on the compiler's workers; draws with this
+        // pipeline until it is ready
+        AsyncPipeline variantAsync(PipelineRegistry& registry, PipelineCompiler& compiler, const PipelineVariant& variant);
+
+        // Rebuilds the pipeline if any of its shaders is in changedPaths and
+        // returns the replaced handle, which the caller destroys once no frame
+        // in flight uses it; VK_NULL_HANDLE if nothing changed. Throws and keeps
+        // the current pipeline if the new shaders fail to build or need a
+        // different layout. Variants are not rebuilt, request them again.
+        VkPipeline reloadShaders(const std::vector<std::filesystem::path>& changedPaths);
+
+        // Takes the variants of shaders replaced by reloadShaders() out of the
+        // registry, once their replacements have been requested. The caller
+        // destroys them when no frame in flight uses them.
+        std::vector<VkPipeline> evictStaleVariants();
+
         VkPipeline handle() const { return m_graphicsPipeline; }
         VkPipelineLayout layout() const { return m_pipelineLayout; }
         const RenderPass& renderPass() const { return m_renderPass; }
+        // Merged across all stages
+        const ShaderReflection& reflection() const { return m_reflection; }
 
     private:
+        PipelineBuilder variantBuilder(PipelineRegistry& registry, const PipelineVariant& variant);
         void createPipelineLayout(const std::vector<VkDescriptorSetLayout>& descriptorLayout);
+        static std::vector<VkPipelineShaderStageCreateInfo> shaderStages(
+            const std::vector<std::shared_ptr<const ShaderModule>>& shaderModules);
+        static void validateVertexInput(const ShaderReflection& reflection);
 
         const std::vector<VkDynamicState> m_dynamicState = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
         
@@ -50,6 +107,16 @@ namespace vkcommon
 
         const Device& m_deviceRef;
         const SwapChain& m_swapChainRef;
+
+        // Shared through the device's ShaderLibrary, kept so variants can be built later
+        std::vector<std::shared_ptr<const ShaderModule>> m_shaderModules;
+        std::vector<std::filesystem::path> m_shaderPaths;
+        ShaderReflection m_reflection;
+        PipelineBuilder m_builder;
+        PipelineRegistry* m_registry{ nullptr };
+        // Replaced by reloadShaders() and held until their variants are
+        // evicted, so no new module reuses a handle still in a registry key
+        std::vector<std::shared_ptr<const ShaderModule>> m_staleShaderModules;
     };
 
 } // namespace vkcommon
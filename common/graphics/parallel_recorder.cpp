@@ -0,0 +1,175 @@
+#include "parallel_recorder.h"
+
+#include "core/device.h"
+#include "graphics/command_pool.h"
+
+#include <algorithm>
+
+namespace vkcommon
+{
+
+    ParallelRecorder::ParallelRecorder(const Device& device, uint32_t queueFamilyIndex,
+        uint32_t framesInFlight, uint32_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        m_frames.resize(framesInFlight);
+        for (auto& frame : m_frames)
+        {
+            frame.resize(threadCount);
+            for (auto& threadPool : frame)
+            {
+                threadPool.pool = std::make_unique<CommandPool>(device, queueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+            }
+        }
+
+        m_errors.resize(threadCount);
+        m_workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; i++)
+        {
+            m_workers.emplace_back(&ParallelRecorder::workerLoop, this, i);
+        }
+    }
+
+    ParallelRecorder::~ParallelRecorder()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_jobAvailable.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ParallelRecorder::beginFrame(uint32_t frameIndex)
+    {
+        m_currentFrame = frameIndex;
+        for (auto& threadPool : m_frames[m_currentFrame])
+        {
+            threadPool.pool->reset();
+            threadPool.used = 0;
+        }
+    }
+
+    std::vector<VkCommandBuffer> ParallelRecorder::record(uint32_t itemCount,
+        VkRenderPass renderPass,
+        uint32_t subpass,
+        VkFramebuffer framebuffer,
+        const RecordFunction& recordRange)
+    {
+        // Fewer ranges than workers when there is little to record
+        uint32_t rangeCount = std::min(threadCount(), itemCount);
+        std::vector<VkCommandBuffer> commandBuffers(rangeCount, VK_NULL_HANDLE);
+        if (rangeCount == 0)
+        {
+            return commandBuffers;
+        }
+
+        std::vector<ThreadPool>& frame = m_frames[m_currentFrame];
+        auto job = [&, rangeCount](uint32_t threadIndex)
+        {
+            if (threadIndex >= rangeCount)
+            {
+                return;
+            }
+
+            // Spread the remainder over the first ranges
+            uint32_t first = static_cast<uint32_t>(uint64_t{ itemCount } * threadIndex / rangeCount);
+            uint32_t last = static_cast<uint32_t>(uint64_t{ itemCount } * (threadIndex + 1) / rangeCount);
+
+            ThreadPool& threadPool = frame[threadIndex];
+            VkCommandBuffer commandBuffer = nextBuffer(threadPool);
+            threadPool.pool->beginSecondaryCommandBuffer(commandBuffer, renderPass, subpass, framebuffer);
+            recordRange(commandBuffer, first, last - first);
+            threadPool.pool->endCommandBuffer(commandBuffer);
+
+            commandBuffers[threadIndex] = commandBuffer;
+        };
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_job = job;
+        std::fill(m_errors.begin(), m_errors.end(), nullptr);
+        m_pending = threadCount();
+        m_generation++;
+        m_jobAvailable.notify_all();
+
+        m_jobDone.wait(lock, [this]() { return m_pending == 0; });
+        m_job = nullptr;
+
+        for (const std::exception_ptr& error : m_errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        return commandBuffers;
+    }
+
+    void ParallelRecorder::execute(VkCommandBuffer primary,
+        uint32_t itemCount,
+        VkRenderPass renderPass,
+        uint32_t subpass,
+        VkFramebuffer framebuffer,
+        const RecordFunction& recordRange)
+    {
+        std::vector<VkCommandBuffer> commandBuffers = record(itemCount, renderPass, subpass, framebuffer, recordRange);
+        if (!commandBuffers.empty())
+        {
+            vkCmdExecuteCommands(primary, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+        }
+    }
+
+    void ParallelRecorder::workerLoop(uint32_t threadIndex)
+    {
+        uint64_t seenGeneration = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobAvailable.wait(lock, [&]() { return m_stopping || m_generation != seenGeneration; });
+                if (m_stopping)
+                {
+                    return;
+                }
+                seenGeneration = m_generation;
+            }
+
+            // m_job stays put until every worker has reported back
+            try
+            {
+                m_job(threadIndex);
+            }
+            catch (...)
+            {
+                m_errors[threadIndex] = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_pending == 0)
+                {
+                    m_jobDone.notify_one();
+                }
+            }
+        }
+    }
+
+    VkCommandBuffer ParallelRecorder::nextBuffer(ThreadPool& threadPool)
+    {
+        if (threadPool.used == threadPool.buffers.size())
+        {
+            threadPool.buffers.push_back(threadPool.pool->allocateSingleBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+        }
+        return threadPool.buffers[threadPool.used++];
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,92 @@
+#ifndef PARALLEL_RECORDER_H
+#define PARALLEL_RECORDER_H
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vkcommon
+{
+    class Device;
+    class CommandPool;
+
+    // Records one render pass's draws into secondary command buffers on
+    // worker threads. Every worker has its own transient pool per frame in
+    // flight, so recording needs no locking and beginFrame() recycles a
+    // frame's buffers with one vkResetCommandPool per worker.
+    class ParallelRecorder
+    {
+    public:
+        // Records items [first, first + count) into commandBuffer. Nothing is
+        // inherited but the render pass: bind pipeline, dynamic state and
+        // descriptor sets first.
+        using RecordFunction = std::function<void(VkCommandBuffer commandBuffer, uint32_t first, uint32_t count)>;
+
+        // threadCount 0 uses every hardware thread
+        ParallelRecorder(const Device& device, uint32_t queueFamilyIndex,
+            uint32_t framesInFlight, uint32_t threadCount = 0);
+        ~ParallelRecorder();
+
+        ParallelRecorder(const ParallelRecorder&) = delete;
+        ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+
+        // Resets the frame's pools; its fence must have signaled
+        void beginFrame(uint32_t frameIndex);
+
+        // Splits [0, itemCount) into one contiguous range per worker and
+        // records them in parallel, blocking until all are done. Returns the
+        // buffers in range order, valid until this frame's next beginFrame().
+        // Rethrows the first exception a worker hit.
+        std::vector<VkCommandBuffer> record(uint32_t itemCount,
+            VkRenderPass renderPass,
+            uint32_t subpass,
+            VkFramebuffer framebuffer,
+            const RecordFunction& recordRange);
+
+        // record() then vkCmdExecuteCommands into primary, whose render pass
+        // must have begun with SECONDARY_COMMAND_BUFFERS contents
+        void execute(VkCommandBuffer primary,
+            uint32_t itemCount,
+            VkRenderPass renderPass,
+            uint32_t subpass,
+            VkFramebuffer framebuffer,
+            const RecordFunction& recordRange);
+
+        uint32_t threadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    private:
+        // One per worker and frame, buffers are reused after each reset
+        struct ThreadPool
+        {
+            std::unique_ptr<CommandPool> pool;
+            std::vector<VkCommandBuffer> buffers;
+            size_t used{ 0 };
+        };
+
+        void workerLoop(uint32_t threadIndex);
+        VkCommandBuffer nextBuffer(ThreadPool& threadPool);
+
+        std::vector<std::vector<ThreadPool>> m_frames;   // [frame][thread]
+        uint32_t m_currentFrame{ 0 };
+
+        std::vector<std::thread> m_workers;
+        std::function<void(uint32_t threadIndex)> m_job;
+        std::vector<std::exception_ptr> m_errors;
+        std::mutex m_mutex;
+        std::condition_variable m_jobAvailable;
+        std::condition_variable m_jobDone;
+        uint64_t m_generation{ 0 };
+        uint32_t m_pending{ 0 };
+        bool m_stopping{ false };
+    };
+
+} // namespace vkcommon
+
+#endif // PARALLEL_RECORDER_H
@@ -3,12 +3,63 @@
 #include "core/device.h"
 #include "graphics/render_pass.h"
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cstring>
 #include <stdexcept>
+#include <string_view>
+#include <type_traits>
 
 namespace vkcommon
 {
 
+    namespace
+    {
+        // Non-dispatchable handles are pointers on 64-bit and uint64_t on 32-bit
+        template <typename Handle>
+        uint64_t handleBits(Handle handle)
+        {
+            if constexpr (std::is_pointer_v<Handle>)
+            {
+                return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+            }
+            else
+            {
+                return static_cast<uint64_t>(handle);
+            }
+        }
+
+        uint64_t floatBits(float value)
+        {
+            return std::bit_cast<uint32_t>(value);
+        }
+
+        void appendBytes(PipelineKey& key, const void* data, size_t size)
+        {
+            key.push_back(size);
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t offset = 0; offset < size; offset += sizeof(uint64_t))
+            {
+                uint64_t word = 0;
+                std::memcpy(&word, bytes + offset, std::min(sizeof(uint64_t), size - offset));
+                key.push_back(word);
+            }
+        }
+    }
+
+    size_t PipelineKeyHash::operator()(const PipelineKey& key) const noexcept
+    {
+        // FNV-1a over the words
+        uint64_t hash = 14695981039346656037ull;
+        for (uint64_t word : key)
+        {
+            hash ^= word;
+            hash *= 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+
     PipelineBuilder::PipelineBuilder(const Device& device) : m_device(device)
     {
         // Default initialization
@@ -23,11 +74,13 @@ namespace vkcommon
         const VkVertexInputBindingDescription& binding,
         const std::array<VkVertexInputAttributeDescription, 5>& attributes)
     {
+        vertexBindings = { binding };
+        vertexAttributes.assign(attributes.begin(), attributes.end());
+
+        // Pointers are set in build(), the builder may have been copied by then
         vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &binding;
-        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size());
-        vertexInputInfo.pVertexAttributeDescriptions = attributes.data();
+        vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexBindings.size());
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttributes.size());
         return *this;
     }
 
@@ -38,6 +91,33 @@ namespace vkcommon
         return *this;
     }
 
+    PipelineBuilder& PipelineBuilder::setSpecialization(
+        const SpecializationConstants& constants,
+        VkShaderStageFlags stages)
+    {
+        specialization = constants;
+        specializationStages = stages;
+        return *this;
+    }
+
+    std::vector<VkPipelineShaderStageCreateInfo> PipelineBuilder::specializedStages(const VkSpecializationInfo& info) const
+    {
+        std::vector<VkPipelineShaderStageCreateInfo> stages = shaderStages;
+        if (specialization.empty())
+        {
+            return stages;
+        }
+
+        for (auto& stage : stages)
+        {
+            if (stage.stage & specializationStages)
+            {
+                stage.pSpecializationInfo = &info;
+            }
+        }
+        return stages;
+    }
+
     PipelineBuilder& PipelineBuilder::setInputAssembly(VkPrimitiveTopology topology)
     {
         inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -88,12 +168,12 @@ namespace vkcommon
         return *this;
     }
 
-    PipelineBuilder& PipelineBuilder::setDepthStencil()
+    PipelineBuilder& PipelineBuilder::setDepthStencil(bool depthTest, bool depthWrite, VkCompareOp compareOp)
     {
         depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-        depthStencil.depthTestEnable = VK_TRUE;
-        depthStencil.depthWriteEnable = VK_TRUE;
-        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+        depthStencil.depthTestEnable = depthTest ? VK_TRUE : VK_FALSE;
+        depthStencil.depthWriteEnable = depthWrite ? VK_TRUE : VK_FALSE;
+        depthStencil.depthCompareOp = compareOp;
         depthStencil.depthBoundsTestEnable = VK_FALSE;
         depthStencil.stencilTestEnable = VK_FALSE;
         return *this;
@@ -114,7 +194,6 @@ namespace vkcommon
         colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
         colorBlending.logicOpEnable = VK_FALSE;
         colorBlending.attachmentCount = 1;
-        colorBlending.pAttachments = &colorBlendAttachment;
         // Optional
         colorBlending.logicOp = VK_LOGIC_OP_COPY;
         colorBlending.blendConstants[0] = 0.0f;
@@ -124,11 +203,12 @@ namespace vkcommon
         return *this;
     }
 
-    PipelineBuilder& PipelineBuilder::setDynamicState(const std::vector<VkDynamicState>& dynamicStates)
+    PipelineBuilder& PipelineBuilder::setDynamicState(const std::vector<VkDynamicState>& states)
     {
+        dynamicStates = states;
+
         dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
         dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-        dynamicState.pDynamicStates = dynamicStates.data();
         return *this;
     }
 
@@ -140,18 +220,31 @@ namespace vkcommon
 
     VkPipeline PipelineBuilder::build(const RenderPass& renderPass) const
     {
+        VkPipelineVertexInputStateCreateInfo vertexInput = vertexInputInfo;
+        vertexInput.pVertexBindingDescriptions = vertexBindings.data();
+        vertexInput.pVertexAttributeDescriptions = vertexAttributes.data();
+
+        VkPipelineColorBlendStateCreateInfo colorBlend = colorBlending;
+        colorBlend.pAttachments = &colorBlendAttachment;
+
+        VkPipelineDynamicStateCreateInfo dynamic = dynamicState;
+        dynamic.pDynamicStates = dynamicStates.data();
+
+        VkSpecializationInfo specializationInfo = specialization.info();
+        std::vector<VkPipelineShaderStageCreateInfo> stages = specializedStages(specializationInfo);
+
         VkGraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
-        pipelineInfo.pStages = shaderStages.data();
-        pipelineInfo.pVertexInputState = &vertexInputInfo;
+        pipelineInfo.stageCount = static_cast<uint32_t>(stages.size());
+        pipelineInfo.pStages = stages.data();
+        pipelineInfo.pVertexInputState = &vertexInput;
         pipelineInfo.pInputAssemblyState = &inputAssembly;
         pipelineInfo.pViewportState = &viewportState;
         pipelineInfo.pRasterizationState = &rasterizer;
         pipelineInfo.pMultisampleState = &multisampling;
         pipelineInfo.pDepthStencilState = &depthStencil;
-        pipelineInfo.pColorBlendState = &colorBlending;
-        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.pColorBlendState = &colorBlend;
+        pipelineInfo.pDynamicState = &dynamic;
         pipelineInfo.layout = pipelineLayout;
         pipelineInfo.renderPass = renderPass;
         pipelineInfo.subpass = 0;
@@ -159,11 +252,97 @@ namespace vkcommon
         pipelineInfo.basePipelineIndex = -1;
 
         VkPipeline pipeline;
-        if (vkCreateGraphicsPipelines(m_device.handle(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+        if (vkCreateGraphicsPipelines(m_device.handle(), m_device.pipelineCache(), 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
         {
             throw std::runtime_error("Failed to create graphics pipeline!");
         }
         return pipeline;
     }
 
+    std::vector<VkShaderModule> PipelineBuilder::shaderModules() const
+    {
+        std::vector<VkShaderModule> modules;
+        modules.reserve(shaderStages.size());
+        for (const auto& stage : shaderStages)
+        {
+            modules.push_back(stage.module);
+        }
+        return modules;
+    }
+
+    PipelineKey PipelineBuilder::key(const RenderPass& renderPass) const
+    {
+        PipelineKey key;
+        key.reserve(128);
+
+        VkSpecializationInfo specializationInfo = specialization.info();
+        for (const auto& stage : specializedStages(specializationInfo))
+        {
+            key.push_back(stage.stage);
+            key.push_back(handleBits(stage.module));
+            std::string_view entry = stage.pName ? stage.pName : "";
+            appendBytes(key, entry.data(), entry.size());
+
+            const VkSpecializationInfo* specialization = stage.pSpecializationInfo;
+            key.push_back(specialization ? specialization->mapEntryCount : 0);
+            if (specialization)
+            {
+                appendBytes(key, specialization->pMapEntries, sizeof(VkSpecializationMapEntry) * specialization->mapEntryCount);
+                appendBytes(key, specialization->pData, specialization->dataSize);
+            }
+        }
+
+        appendBytes(key, vertexBindings.data(), sizeof(VkVertexInputBindingDescription) * vertexBindings.size());
+        appendBytes(key, vertexAttributes.data(), sizeof(VkVertexInputAttributeDescription) * vertexAttributes.size());
+
+        key.push_back(inputAssembly.topology);
+        key.push_back(inputAssembly.primitiveRestartEnable);
+
+        key.push_back(viewportState.viewportCount);
+        key.push_back(viewportState.scissorCount);
+
+        key.push_back(rasterizer.depthClampEnable);
+        key.push_back(rasterizer.rasterizerDiscardEnable);
+        key.push_back(rasterizer.polygonMode);
+        key.push_back(rasterizer.cullMode);
+        key.push_back(rasterizer.frontFace);
+        key.push_back(rasterizer.depthBiasEnable);
+        key.push_back(floatBits(rasterizer.depthBiasConstantFactor));
+        key.push_back(floatBits(rasterizer.depthBiasClamp));
+        key.push_back(floatBits(rasterizer.depthBiasSlopeFactor));
+        key.push_back(floatBits(rasterizer.lineWidth));
+
+        key.push_back(multisampling.rasterizationSamples);
+        key.push_back(multisampling.sampleShadingEnable);
+        key.push_back(floatBits(multisampling.minSampleShading));
+        key.push_back(multisampling.alphaToCoverageEnable);
+        key.push_back(multisampling.alphaToOneEnable);
+
+        key.push_back(depthStencil.depthTestEnable);
+        key.push_back(depthStencil.depthWriteEnable);
+        key.push_back(depthStencil.depthCompareOp);
+        key.push_back(depthStencil.depthBoundsTestEnable);
+        key.push_back(depthStencil.stencilTestEnable);
+        appendBytes(key, &depthStencil.front, sizeof(VkStencilOpState));
+        appendBytes(key, &depthStencil.back, sizeof(VkStencilOpState));
+
+        appendBytes(key, &colorBlendAttachment, sizeof(colorBlendAttachment));
+        key.push_back(colorBlending.logicOpEnable);
+        key.push_back(colorBlending.logicOp);
+        key.push_back(colorBlending.attachmentCount);
+        for (float constant : colorBlending.blendConstants)
+        {
+            key.push_back(floatBits(constant));
+        }
+
+        appendBytes(key, dynamicStates.data(), sizeof(VkDynamicState) * dynamicStates.size());
+
+        key.push_back(handleBits(pipelineLayout));
+
+        const std::vector<uint32_t>& compatibility = renderPass.compatibilityKey();
+        key.insert(key.end(), compatibility.begin(), compatibility.end());
+
+        return key;
+    }
+
 } // namespace vkcommon
\ No newline at end of file
@@ -1,14 +1,28 @@
 #ifndef PIPELINE_BUILDER_H
 #define PIPELINE_BUILDER_H
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <vulkan/vulkan.h>
 
+#include "graphics/specialization_constants.h"
+
 namespace vkcommon
 {
     class Device;
     class RenderPass;
 
+    // Flattened pipeline state, equal keys build identical pipelines
+    using PipelineKey = std::vector<uint64_t>;
+
+    struct PipelineKeyHash
+    {
+        size_t operator()(const PipelineKey& key) const noexcept;
+    };
+
+    // Holds its own copy of every array it is given, so a builder can be kept
+    // and copied to derive variants after the caller's data is gone
     class PipelineBuilder
     {
     public:
@@ -17,22 +31,40 @@ namespace vkcommon
         PipelineBuilder& setVertexInput(const VkVertexInputBindingDescription& binding,
             const std::array<VkVertexInputAttributeDescription, 5>& attributes);
         PipelineBuilder& setShaderStages(const std::vector<VkPipelineShaderStageCreateInfo>& stages);
+        // Applied to every shader stage in stages; ids a stage does not declare are ignored
+        PipelineBuilder& setSpecialization(const SpecializationConstants& constants,
+            VkShaderStageFlags stages = VK_SHADER_STAGE_ALL_GRAPHICS);
         PipelineBuilder& setInputAssembly(VkPrimitiveTopology topology);
         PipelineBuilder& setViewport();
         PipelineBuilder& setRasterizer(VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL);
         PipelineBuilder& setMultisampling();
-        PipelineBuilder& setDepthStencil();
+        PipelineBuilder& setDepthStencil(bool depthTest = true, bool depthWrite = true,
+            VkCompareOp compareOp = VK_COMPARE_OP_LESS);
         PipelineBuilder& setColorBlending();
-        PipelineBuilder& setDynamicState(const std::vector<VkDynamicState>& dynamicStates);
+        PipelineBuilder& setDynamicState(const std::vector<VkDynamicState>& states);
         PipelineBuilder& setPipelineLayout(VkPipelineLayout layout);
 
         VkPipeline build(const RenderPass& renderPass) const;
 
+        // Every field that affects the pipeline, including shader modules and
+        // layout handles and the render pass compatibility
+        PipelineKey key(const RenderPass& renderPass) const;
+
+        VkPipelineLayout layout() const { return pipelineLayout; }
+        std::vector<VkShaderModule> shaderModules() const;
+
     private:
+        // shaderStages with pSpecializationInfo pointing at info where it applies
+        std::vector<VkPipelineShaderStageCreateInfo> specializedStages(const VkSpecializationInfo& info) const;
+
         const Device& m_device;
 
         VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        std::vector<VkVertexInputBindingDescription> vertexBindings;
+        std::vector<VkVertexInputAttributeDescription> vertexAttributes;
         std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+        SpecializationConstants specialization;
+        VkShaderStageFlags specializationStages{ 0 };
         VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
         VkPipelineViewportStateCreateInfo viewportState{};
         VkPipelineRasterizationStateCreateInfo rasterizer{};
@@ -41,6 +73,7 @@ namespace vkcommon
         VkPipelineColorBlendStateCreateInfo colorBlending{};
         VkPipelineDepthStencilStateCreateInfo depthStencil{};
         VkPipelineDynamicStateCreateInfo dynamicState{};
+        std::vector<VkDynamicState> dynamicStates;
         VkPipelineLayout pipelineLayout{};
     };
 
@@ -0,0 +1,114 @@
+#include "pipeline_compiler.h"
+
+#include "graphics/pipeline_builder.h"
+#include "graphics/render_pass.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace vkcommon
+{
+
+    PipelineCompiler::PipelineCompiler(uint32_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            // Leave one thread to the render loop; hardware_concurrency() may
+            // be 0, which must not wrap around
+            threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        }
+
+        m_workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; i++)
+        {
+            m_workers.emplace_back(&PipelineCompiler::workerLoop, this);
+        }
+    }
+
+    PipelineCompiler::~PipelineCompiler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_jobAvailable.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    std::shared_future<VkPipeline> PipelineCompiler::compile(const PipelineBuilder& builder, const RenderPass& renderPass)
+    {
+        // packaged_task is move-only, std::function needs a copyable callable
+        auto task = std::make_shared<std::packaged_task<VkPipeline()>>(
+            [builder, &renderPass]() { return builder.build(renderPass); });
+        std::shared_future<VkPipeline> future = task->get_future().share();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.emplace_back([task]() { (*task)(); });
+        }
+        m_jobAvailable.notify_one();
+
+        return future;
+    }
+
+    void PipelineCompiler::waitIdle()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]() { return m_jobs.empty() && m_running == 0; });
+    }
+
+    void PipelineCompiler::workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobAvailable.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+
+                // Drain the queue before stopping so no future is left unset
+                if (m_jobs.empty())
+                {
+                    return;
+                }
+
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+                m_running++;
+            }
+
+            // Exceptions end up in the job's future
+            job();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_running--;
+                if (m_jobs.empty() && m_running == 0)
+                {
+                    m_idle.notify_all();
+                }
+            }
+        }
+    }
+
+    AsyncPipeline::AsyncPipeline(std::shared_future<VkPipeline> pipeline, VkPipeline fallback)
+        : m_pipeline(std::move(pipeline)), m_fallback(fallback)
+    {
+    }
+
+    bool AsyncPipeline::isReady() const
+    {
+        return m_pipeline.valid() && m_pipeline.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    VkPipeline AsyncPipeline::current() const
+    {
+        return isReady() ? m_pipeline.get() : m_fallback;
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,73 @@
+#ifndef PIPELINE_COMPILER_H
+#define PIPELINE_COMPILER_H
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vkcommon
+{
+    class RenderPass;
+    class PipelineBuilder;
+
+    // Builds pipelines on worker threads. Creation only touches the shared
+    // VkPipelineCache, which the driver synchronizes internally.
+    class PipelineCompiler
+    {
+    public:
+        // threadCount 0 uses all but one hardware thread
+        explicit PipelineCompiler(uint32_t threadCount = 0);
+        // Finishes every queued job before returning
+        ~PipelineCompiler();
+
+        PipelineCompiler(const PipelineCompiler&) = delete;
+        PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+        // The builder is copied; shader modules, layout, render pass and any
+        // specialization data it points to must stay alive until the future
+        // is ready. The caller owns the resulting pipeline.
+        std::shared_future<VkPipeline> compile(const PipelineBuilder& builder, const RenderPass& renderPass);
+
+        void waitIdle();
+
+        size_t threadCount() const { return m_workers.size(); }
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> m_workers;
+        std::deque<std::function<void()>> m_jobs;
+        std::mutex m_mutex;
+        std::condition_variable m_jobAvailable;
+        std::condition_variable m_idle;
+        uint32_t m_running{ 0 };
+        bool m_stopping{ false };
+    };
+
+    // A pipeline being compiled and the one to draw with until it is ready
+    class AsyncPipeline
+    {
+    public:
+        AsyncPipeline() = default;
+        AsyncPipeline(std::shared_future<VkPipeline> pipeline, VkPipeline fallback);
+
+        bool isReady() const;
+
+        // Never blocks: the compiled pipeline once ready, the fallback before.
+        // Rethrows if compilation failed.
+        VkPipeline current() const;
+
+    private:
+        std::shared_future<VkPipeline> m_pipeline;
+        VkPipeline m_fallback{ VK_NULL_HANDLE };
+    };
+
+} // namespace vkcommon
+
+#endif // PIPELINE_COMPILER_H
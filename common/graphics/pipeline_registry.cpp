@@ -0,0 +1,126 @@
+#include "pipeline_registry.h"
+
+#include "core/device.h"
+#include "graphics/render_pass.h"
+#include "graphics/pipeline_compiler.h"
+
+#include <algorithm>
+
+namespace vkcommon
+{
+
+    PipelineRegistry::PipelineRegistry(const Device& device)
+        : m_deviceRef(device)
+    {
+    }
+
+    PipelineRegistry::~PipelineRegistry()
+    {
+        clear();
+    }
+
+    VkPipeline PipelineRegistry::getOrCreate(const PipelineBuilder& builder, const RenderPass& renderPass)
+    {
+        PipelineKey key = builder.key(renderPass);
+
+        auto it = m_pipelines.find(key);
+        if (it != m_pipelines.end())
+        {
+            m_hits++;
+            return it->second.pipeline.get();
+        }
+
+        m_misses++;
+        std::promise<VkPipeline> built;
+        built.set_value(builder.build(renderPass));
+
+        auto& entry = m_pipelines.emplace(std::move(key), Entry{ built.get_future().share(), builder.layout(), builder.shaderModules() }).first->second;
+        return entry.pipeline.get();
+    }
+
+    std::shared_future<VkPipeline> PipelineRegistry::getOrCreateAsync(
+        const PipelineBuilder& builder,
+        const RenderPass& renderPass,
+        PipelineCompiler& compiler)
+    {
+        PipelineKey key = builder.key(renderPass);
+
+        auto it = m_pipelines.find(key);
+        if (it != m_pipelines.end())
+        {
+            m_hits++;
+            return it->second.pipeline;
+        }
+
+        m_misses++;
+        std::shared_future<VkPipeline> pipeline = compiler.compile(builder, renderPass);
+        m_pipelines.emplace(std::move(key), Entry{ pipeline, builder.layout(), builder.shaderModules() });
+        return pipeline;
+    }
+
+    void PipelineRegistry::destroy(const Entry& entry)
+    {
+        try
+        {
+            vkDestroyPipeline(m_deviceRef.handle(), entry.pipeline.get(), nullptr);
+        }
+        catch (const std::exception&)
+        {
+            // Compilation failed, nothing was created
+        }
+    }
+
+    void PipelineRegistry::release(VkPipelineLayout layout)
+    {
+        for (auto it = m_pipelines.begin(); it != m_pipelines.end();)
+        {
+            if (it->second.layout == layout)
+            {
+                destroy(it->second);
+                it = m_pipelines.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    std::vector<VkPipeline> PipelineRegistry::evict(const std::vector<VkShaderModule>& shaderModules)
+    {
+        std::vector<VkPipeline> evicted;
+        for (auto it = m_pipelines.begin(); it != m_pipelines.end();)
+        {
+            const std::vector<VkShaderModule>& used = it->second.shaderModules;
+            bool stale = std::any_of(used.begin(), used.end(), [&shaderModules](VkShaderModule module) {
+                return std::find(shaderModules.begin(), shaderModules.end(), module) != shaderModules.end();
+            });
+            if (!stale)
+            {
+                ++it;
+                continue;
+            }
+
+            try
+            {
+                evicted.push_back(it->second.pipeline.get());
+            }
+            catch (const std::exception&)
+            {
+                // Compilation failed, nothing was created
+            }
+            it = m_pipelines.erase(it);
+        }
+        return evicted;
+    }
+
+    void PipelineRegistry::clear()
+    {
+        for (const auto& [key, entry] : m_pipelines)
+        {
+            destroy(entry);
+        }
+        m_pipelines.clear();
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,73 @@
+#ifndef PIPELINE_REGISTRY_H
+#define PIPELINE_REGISTRY_H
+
+#include <vulkan/vulkan.h>
+
+#include <future>
+#include <unordered_map>
+#include <vector>
+
+#include "graphics/pipeline_builder.h"
+
+namespace vkcommon
+{
+    class Device;
+    class RenderPass;
+    class PipelineCompiler;
+
+    // Shares VkPipelines between everything asking for the same state. The
+    // key is the builder's complete state, so a hit always returns a
+    // pipeline identical to the one that would have been built.
+    class PipelineRegistry
+    {
+    public:
+        explicit PipelineRegistry(const Device& device);
+        ~PipelineRegistry();
+
+        PipelineRegistry(const PipelineRegistry&) = delete;
+        PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+        // Owned by the registry, valid until released or cleared. Waits if the
+        // same state is still being compiled asynchronously.
+        VkPipeline getOrCreate(const PipelineBuilder& builder, const RenderPass& renderPass);
+
+        // Same, but a miss is compiled on the compiler's workers
+        std::shared_future<VkPipeline> getOrCreateAsync(
+            const PipelineBuilder& builder,
+            const RenderPass& renderPass,
+            PipelineCompiler& compiler);
+
+        // Destroys the pipelines built with layout. Call before destroying the
+        // layout or the shader modules used with it, their handles may be reused.
+        void release(VkPipelineLayout layout);
+        // Removes the pipelines built with any of shaderModules and returns
+        // them instead of destroying them, for callers that must wait until
+        // no frame in flight uses them. Waits for pending compilations.
+        std::vector<VkPipeline> evict(const std::vector<VkShaderModule>& shaderModules);
+        void clear();
+
+        size_t size() const { return m_pipelines.size(); }
+        size_t hits() const { return m_hits; }
+        size_t misses() const { return m_misses; }
+
+    private:
+        struct Entry
+        {
+            std::shared_future<VkPipeline> pipeline;
+            VkPipelineLayout layout;
+            std::vector<VkShaderModule> shaderModules;
+        };
+
+        // Waits for a pending compilation; failed ones own no pipeline
+        void destroy(const Entry& entry);
+
+        std::unordered_map<PipelineKey, Entry, PipelineKeyHash> m_pipelines;
+        size_t m_hits{ 0 };
+        size_t m_misses{ 0 };
+
+        const Device& m_deviceRef;
+    };
+
+} // namespace vkcommon
+
+#endif // PIPELINE_REGISTRY_H
@@ -0,0 +1,58 @@
+#include "prerecorded_commands.h"
+
+#include "core/device.h"
+#include "graphics/command_pool.h"
+
+namespace vkcommon
+{
+
+    PrerecordedCommands::PrerecordedCommands(const Device& device, uint32_t queueFamilyIndex, uint32_t framesInFlight)
+        : m_commandPool(std::make_unique<CommandPool>(device, queueFamilyIndex))
+        , m_frames(framesInFlight)
+    {
+    }
+
+    PrerecordedCommands::~PrerecordedCommands() = default;
+
+    void PrerecordedCommands::invalidate()
+    {
+        for (auto& frame : m_frames)
+        {
+            for (auto& slot : frame)
+            {
+                slot.dirty = true;
+            }
+        }
+    }
+
+    VkCommandBuffer PrerecordedCommands::get(uint32_t frameIndex, uint32_t imageIndex, const RecordFunction& record)
+    {
+        // Images are added as they are first acquired
+        std::vector<Slot>& frame = m_frames[frameIndex];
+        if (imageIndex >= frame.size())
+        {
+            frame.resize(imageIndex + 1);
+        }
+
+        Slot& slot = frame[imageIndex];
+        if (slot.commandBuffer == VK_NULL_HANDLE)
+        {
+            slot.commandBuffer = m_commandPool->allocateSingleBuffer();
+        }
+
+        if (slot.dirty)
+        {
+            // Not ONE_TIME_SUBMIT, the buffer is submitted every time the slot
+            // and image come around. Beginning it again resets it implicitly.
+            m_commandPool->beginCommandBuffer(slot.commandBuffer, 0);
+            record(slot.commandBuffer, frameIndex, imageIndex);
+            m_commandPool->endCommandBuffer(slot.commandBuffer);
+
+            slot.dirty = false;
+            m_recordCount++;
+        }
+
+        return slot.commandBuffer;
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,58 @@
+#ifndef PRERECORDED_COMMANDS_H
+#define PRERECORDED_COMMANDS_H
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace vkcommon
+{
+    class Device;
+    class CommandPool;
+
+    // Command buffers of a static scene, recorded once per frame in flight
+    // and swapchain image and submitted again every frame. Only uniform data
+    // may change between frames; anything baked into the commands (pipelines,
+    // meshes, push constants, framebuffers) needs invalidate() when it does.
+    class PrerecordedCommands
+    {
+    public:
+        // Records the commands only, get() begins and ends the buffer
+        using RecordFunction = std::function<void(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex)>;
+
+        PrerecordedCommands(const Device& device, uint32_t queueFamilyIndex, uint32_t framesInFlight);
+        ~PrerecordedCommands();
+
+        PrerecordedCommands(const PrerecordedCommands&) = delete;
+        PrerecordedCommands& operator=(const PrerecordedCommands&) = delete;
+
+        // Every buffer is recorded again on its next get(), e.g. after a
+        // pipeline swap, a new mesh or a swapchain resize
+        void invalidate();
+
+        // Buffer for this frame slot and image, recorded first if it is new or
+        // invalidated. Only ever submitted from its own slot, so once that
+        // slot's fence has signaled the buffer is free to record again.
+        VkCommandBuffer get(uint32_t frameIndex, uint32_t imageIndex, const RecordFunction& record);
+
+        // Buffers recorded so far, stays put while the scene is static
+        uint64_t recordCount() const { return m_recordCount; }
+
+    private:
+        struct Slot
+        {
+            VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+            bool dirty{ true };
+        };
+
+        std::unique_ptr<CommandPool> m_commandPool;
+        std::vector<std::vector<Slot>> m_frames;   // [frame][image]
+        uint64_t m_recordCount{ 0 };
+    };
+
+} // namespace vkcommon
+
+#endif // PRERECORDED_COMMANDS_H
@@ -0,0 +1,29 @@
+#ifndef PUSH_CONSTANTS_H
+#define PUSH_CONSTANTS_H
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace vkcommon
+{
+    // Records vkCmdPushConstants for a whole struct. stages must name every
+    // stage of the layout's range that covers the written bytes.
+    template <typename T>
+    void pushConstants(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout layout,
+        VkShaderStageFlags stages,
+        const T& data,
+        uint32_t offset = 0)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Push constants are copied byte for byte");
+        static_assert(sizeof(T) % 4 == 0, "Push constant sizes must be a multiple of 4");
+
+        vkCmdPushConstants(commandBuffer, layout, stages, offset, static_cast<uint32_t>(sizeof(T)), &data);
+    }
+
+} // namespace vkcommon
+
+#endif // PUSH_CONSTANTS_H
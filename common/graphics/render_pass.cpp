@@ -69,6 +69,13 @@ namespace vkcommon
 
         std::array<VkAttachmentDescription, 3> attachments = { colorAttachment, depthAttachment, colorAttachmentResolve };
 
+        // One subpass with color, depth and resolve in that order
+        for (const auto& attachment : attachments)
+        {
+            m_compatibilityKey.push_back(attachment.format);
+            m_compatibilityKey.push_back(attachment.samples);
+        }
+
         VkRenderPassCreateInfo renderPassCreateInfo{};
         renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
         renderPassCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
@@ -90,7 +97,7 @@ namespace vkcommon
     }
 
     void RenderPass::begin(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer,
-        VkExtent2D extent, const std::vector<VkClearValue>& clearValues) const
+        VkExtent2D extent, const std::vector<VkClearValue>& clearValues, VkSubpassContents contents) const
     {
         VkRenderPassBeginInfo renderPassInfo{};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -101,7 +108,7 @@ namespace vkcommon
         renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
         renderPassInfo.pClearValues = clearValues.data();
 
-        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, contents);
     }
 
     void RenderPass::end(VkCommandBuffer commandBuffer) const
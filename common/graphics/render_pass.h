@@ -20,13 +20,20 @@ namespace vkcommon
         RenderPass(const RenderPass&) = delete;
         RenderPass& operator=(const RenderPass&) = delete;
 
-        void begin(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, VkExtent2D extent, const std::vector<VkClearValue>& clearValues) const;
+        // SECONDARY_COMMAND_BUFFERS contents when the pass is recorded through vkCmdExecuteCommands
+        void begin(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, VkExtent2D extent, const std::vector<VkClearValue>& clearValues,
+            VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE) const;
         void end(VkCommandBuffer commandBuffer) const;
 
         operator VkRenderPass() const noexcept { return m_renderPass; }
 
+        // Attachment formats and sample counts; pipelines built for one render
+        // pass can be used with any other that has the same key
+        const std::vector<uint32_t>& compatibilityKey() const { return m_compatibilityKey; }
+
     private:
         VkRenderPass m_renderPass;
+        std::vector<uint32_t> m_compatibilityKey;
         const Device& m_deviceRef;
         const SwapChain& m_swapChainRef;
     };
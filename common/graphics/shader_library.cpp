@@ -0,0 +1,139 @@
+#include "shader_library.h"
+
+#include "core/device.h"
+#include "core/mapped_file.h"
+#include "graphics/shader_module.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace vkcommon
+{
+
+    ShaderLibrary::ShaderLibrary(const Device& device)
+        : m_deviceRef(device)
+    {
+    }
+
+    std::shared_ptr<const ShaderModule> ShaderLibrary::load(const std::filesystem::path& spirvPath)
+    {
+        auto pathIt = m_byPath.find(pathKey(spirvPath));
+        if (pathIt != m_byPath.end())
+        {
+            if (std::shared_ptr<const ShaderModule> module = pathIt->second.lock())
+            {
+                m_hits++;
+                return module;
+            }
+        }
+
+        return loadFile(spirvPath);
+    }
+
+    std::shared_ptr<const ShaderModule> ShaderLibrary::reload(const std::filesystem::path& spirvPath)
+    {
+        // The path keeps its old module if the new file fails to load
+        return loadFile(spirvPath);
+    }
+
+    std::string ShaderLibrary::pathKey(const std::filesystem::path& spirvPath)
+    {
+        return std::filesystem::absolute(spirvPath).lexically_normal().string();
+    }
+
+    std::shared_ptr<const ShaderModule> ShaderLibrary::loadFile(const std::filesystem::path& spirvPath)
+    {
+        MappedFile file(spirvPath);
+        if (file.size() % sizeof(uint32_t) != 0)
+        {
+            throw std::runtime_error("Failed to load shader, size is not a multiple of 4: " + spirvPath.string());
+        }
+
+        const uint32_t* code = file.words();
+        size_t wordCount = file.wordCount();
+
+        std::vector<Entry>& entries = m_byContent[hash(code, wordCount)];
+        auto contentIt = std::find_if(entries.begin(), entries.end(), [code, wordCount](const Entry& entry) {
+            return matches(entry, code, wordCount);
+        });
+
+        if (contentIt != entries.end())
+        {
+            m_hits++;
+            m_byPath[pathKey(spirvPath)] = contentIt->module;
+            return contentIt->module;
+        }
+
+        m_misses++;
+        auto module = std::make_shared<const ShaderModule>(m_deviceRef, code, wordCount);
+        entries.push_back(Entry{ wordCount, spirvPath, module });
+        m_byPath[pathKey(spirvPath)] = module;
+        return module;
+    }
+
+    void ShaderLibrary::trim()
+    {
+        for (auto it = m_byContent.begin(); it != m_byContent.end();)
+        {
+            std::vector<Entry>& entries = it->second;
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry& entry) {
+                return entry.module.use_count() == 1;
+            }), entries.end());
+
+            it = entries.empty() ? m_byContent.erase(it) : std::next(it);
+        }
+
+        for (auto it = m_byPath.begin(); it != m_byPath.end();)
+        {
+            it = it->second.expired() ? m_byPath.erase(it) : std::next(it);
+        }
+    }
+
+    void ShaderLibrary::clear()
+    {
+        m_byPath.clear();
+        m_byContent.clear();
+    }
+
+    size_t ShaderLibrary::size() const
+    {
+        size_t count = 0;
+        for (const auto& [contentHash, entries] : m_byContent)
+        {
+            count += entries.size();
+        }
+        return count;
+    }
+
+    uint64_t ShaderLibrary::hash(const uint32_t* code, size_t wordCount)
+    {
+        // FNV-1a over the words
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < wordCount; i++)
+        {
+            hash ^= code[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool ShaderLibrary::matches(const Entry& entry, const uint32_t* code, size_t wordCount)
+    {
+        if (entry.wordCount != wordCount)
+        {
+            return false;
+        }
+
+        // A missing file only costs a new module
+        try
+        {
+            MappedFile file(entry.path);
+            return file.wordCount() == wordCount && std::equal(code, code + wordCount, file.words());
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+    }
+
+} // namespace vkcommon
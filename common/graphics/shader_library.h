@@ -0,0 +1,79 @@
+#ifndef SHADER_LIBRARY_H
+#define SHADER_LIBRARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkcommon
+{
+    class Device;
+    class ShaderModule;
+
+    // Shader modules shared by every pipeline on a device. Files are mapped
+    // rather than copied, and modules are deduplicated by SPIR-V content, so
+    // two paths holding the same code share one VkShaderModule. Modules stay
+    // alive after their pipelines are created so variants and later
+    // pipelines reuse them; trim() drops the ones nothing references.
+    class ShaderLibrary
+    {
+    public:
+        explicit ShaderLibrary(const Device& device);
+        ~ShaderLibrary() = default;
+
+        ShaderLibrary(const ShaderLibrary&) = delete;
+        ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+        // Throws if the file is missing or not valid SPIR-V
+        std::shared_ptr<const ShaderModule> load(const std::filesystem::path& spirvPath);
+        // Reads the file again even if the path was loaded before. Returns the
+        // old module when the code did not change; the old module stays alive
+        // as long as pipelines hold it.
+        std::shared_ptr<const ShaderModule> reload(const std::filesystem::path& spirvPath);
+
+        // Key under which paths are cached and compared
+        static std::string pathKey(const std::filesystem::path& spirvPath);
+
+        // Releases modules held only by the library
+        void trim();
+        void clear();
+
+        // Distinct modules, paths with the same code count once
+        size_t size() const;
+        // Loads served without creating a module, by path or by content
+        size_t hits() const { return m_hits; }
+        size_t misses() const { return m_misses; }
+
+    private:
+        // The code itself is not kept; a file it was loaded from is mapped
+        // again to confirm a hash match
+        struct Entry
+        {
+            size_t wordCount;
+            std::filesystem::path path;
+            std::shared_ptr<const ShaderModule> module;
+        };
+
+        // Skips the path cache, still deduplicates by content
+        std::shared_ptr<const ShaderModule> loadFile(const std::filesystem::path& spirvPath);
+        static uint64_t hash(const uint32_t* code, size_t wordCount);
+        // False as well when the entry's file was removed or rewritten since
+        static bool matches(const Entry& entry, const uint32_t* code, size_t wordCount);
+
+        // Only m_byContent owns the modules
+        std::unordered_map<std::string, std::weak_ptr<const ShaderModule>> m_byPath;
+        // Entries sharing a hash and size are told apart by their files' bytes
+        std::unordered_map<uint64_t, std::vector<Entry>> m_byContent;
+        size_t m_hits{ 0 };
+        size_t m_misses{ 0 };
+
+        const Device& m_deviceRef;
+    };
+
+} // namespace vkcommon
+
+#endif // SHADER_LIBRARY_H
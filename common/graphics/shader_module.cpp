@@ -1,8 +1,8 @@
 #include "shader_module.h"
 
 #include "core/device.h"
+#include "core/mapped_file.h"
 
-#include <fstream>
 #include <stdexcept>
 
 namespace vkcommon
@@ -10,12 +10,30 @@ namespace vkcommon
     ShaderModule::ShaderModule(const Device& device, const std::filesystem::path& spirvPath)
         : m_deviceRef(device)
     {
-        auto code = readFile(spirvPath);
+        MappedFile file(spirvPath);
+        if (file.size() % sizeof(uint32_t) != 0)
+        {
+            throw std::runtime_error("Failed to load shader, size is not a multiple of 4: " + spirvPath.string());
+        }
+
+        create(file.words(), file.wordCount());
+    }
+
+    ShaderModule::ShaderModule(const Device& device, const uint32_t* code, size_t wordCount)
+        : m_deviceRef(device)
+    {
+        create(code, wordCount);
+    }
+
+    void ShaderModule::create(const uint32_t* code, size_t wordCount)
+    {
+        // Validates the header before the driver sees the code
+        m_reflection = ShaderReflection(code, wordCount);
 
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = code.size();
-        createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+        createInfo.codeSize = wordCount * sizeof(uint32_t);
+        createInfo.pCode = code;
 
         if (vkCreateShaderModule(m_deviceRef.handle(), &createInfo, nullptr, &m_module) != VK_SUCCESS)
         {
@@ -38,8 +56,9 @@ namespace vkcommon
     }
 
     ShaderModule::ShaderModule(ShaderModule&& other) noexcept
-        : m_deviceRef(other.m_deviceRef),
-        m_module(other.m_module)
+        : m_module(other.m_module),
+        m_reflection(std::move(other.m_reflection)),
+        m_deviceRef(other.m_deviceRef)
     {   
         other.m_module = VK_NULL_HANDLE;
     }
@@ -50,27 +69,10 @@ namespace vkcommon
         {
             destroy();
             m_module = other.m_module;
+            m_reflection = std::move(other.m_reflection);
             other.m_module = VK_NULL_HANDLE;
         }
         return *this;
     }
 
-    std::vector<char> ShaderModule::readFile(const std::filesystem::path& path) const
-    {
-        std::ifstream file(path, std::ios::ate | std::ios::binary);
-
-        if (!file.is_open())
-        {
-            throw std::runtime_error("Failed to open file: " + path.string());
-        }
-
-        size_t fileSize = static_cast<size_t>(file.tellg());
-        std::vector<char> buffer(fileSize);
-
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-        file.close();
-
-        return buffer;
-    }
 } // namespace vkcommon
\ No newline at end of file
@@ -3,8 +3,11 @@
 
 #include <vulkan/vulkan.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
-#include <vector>
+
+#include "graphics/shader_reflection.h"
 
 namespace vkcommon
 {
@@ -14,6 +17,7 @@ namespace vkcommon
     {
     public:
         ShaderModule(const Device& device, const std::filesystem::path& spirvPath);
+        ShaderModule(const Device& device, const uint32_t* code, size_t wordCount);
         ~ShaderModule();
         
         // Disable copy semantics
@@ -26,11 +30,15 @@ namespace vkcommon
 
         operator VkShaderModule() const noexcept { return m_module; }
 
+        // Bindings, push constants and inputs of this stage
+        const ShaderReflection& reflection() const noexcept { return m_reflection; }
+
     private:
+        void create(const uint32_t* code, size_t wordCount);
         void destroy() noexcept;
-        std::vector<char> readFile(const std::filesystem::path& filename) const;
 
-        VkShaderModule m_module;
+        VkShaderModule m_module{ VK_NULL_HANDLE };
+        ShaderReflection m_reflection;
         const Device& m_deviceRef;
     };
 }
@@ -0,0 +1,592 @@
+#include "shader_reflection.h"
+
+#include "core/mapped_file.h"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace vkcommon
+{
+
+    namespace
+    {
+        // The subset of spirv.h the reflection needs
+        namespace spv
+        {
+            constexpr uint32_t kMagic = 0x07230203;
+            constexpr size_t kHeaderWords = 5;
+
+            enum Op : uint32_t
+            {
+                OpEntryPoint = 15,
+                OpTypeInt = 21,
+                OpTypeFloat = 22,
+                OpTypeVector = 23,
+                OpTypeMatrix = 24,
+                OpTypeImage = 25,
+                OpTypeSampler = 26,
+                OpTypeSampledImage = 27,
+                OpTypeArray = 28,
+                OpTypeRuntimeArray = 29,
+                OpTypeStruct = 30,
+                OpTypePointer = 32,
+                OpConstant = 43,
+                OpVariable = 59,
+                OpDecorate = 71,
+                OpMemberDecorate = 72,
+            };
+
+            enum Decoration : uint32_t
+            {
+                Block = 2,
+                BufferBlock = 3,
+                ArrayStride = 6,
+                MatrixStride = 7,
+                BuiltIn = 11,
+                Location = 30,
+                Binding = 33,
+                DescriptorSet = 34,
+                Offset = 35,
+            };
+
+            enum StorageClass : uint32_t
+            {
+                UniformConstant = 0,
+                Input = 1,
+                Uniform = 2,
+                PushConstant = 9,
+                StorageBuffer = 12,
+            };
+
+            enum Dim : uint32_t
+            {
+                DimBuffer = 5,
+                DimSubpassData = 6,
+            };
+        }
+
+        struct SpirvId
+        {
+            uint32_t opcode = 0;
+            std::vector<uint32_t> operands;
+
+            std::optional<uint32_t> set;
+            std::optional<uint32_t> binding;
+            std::optional<uint32_t> location;
+            std::optional<uint32_t> arrayStride;
+            bool builtIn = false;
+            bool block = false;
+            bool bufferBlock = false;
+
+            std::vector<uint32_t> memberOffsets;
+            std::vector<uint32_t> memberMatrixStrides;
+        };
+
+        class SpirvModule
+        {
+        public:
+            SpirvModule(const uint32_t* code, size_t wordCount)
+            {
+                if (code == nullptr || wordCount < spv::kHeaderWords || code[0] != spv::kMagic)
+                {
+                    throw std::runtime_error("Failed to reflect shader: not a SPIR-V module!");
+                }
+
+                m_ids.resize(code[3]);  // Id bound
+
+                size_t offset = spv::kHeaderWords;
+                while (offset < wordCount)
+                {
+                    uint32_t opcode = code[offset] & 0xffff;
+                    uint32_t length = code[offset] >> 16;
+                    if (length == 0 || offset + length > wordCount)
+                    {
+                        throw std::runtime_error("Failed to reflect shader: truncated SPIR-V instruction!");
+                    }
+
+                    parseInstruction(opcode, code + offset + 1, length - 1);
+                    offset += length;
+                }
+            }
+
+            const SpirvId& id(uint32_t index) const
+            {
+                if (index >= m_ids.size())
+                {
+                    throw std::runtime_error("Failed to reflect shader: SPIR-V id out of range!");
+                }
+                return m_ids[index];
+            }
+
+            size_t idCount() const { return m_ids.size(); }
+            VkShaderStageFlagBits stage() const { return m_stage; }
+
+            // Value of an OpConstant used as an array length
+            uint32_t constant(uint32_t index) const
+            {
+                const SpirvId& value = id(index);
+                if (value.opcode != spv::OpConstant || value.operands.size() < 3)
+                {
+                    throw std::runtime_error("Failed to reflect shader: array length is not a constant!");
+                }
+                return value.operands[2];
+            }
+
+            // Byte size of a type as laid out in a block; matrixStride comes
+            // from the member decoration of the enclosing struct
+            uint32_t typeSize(uint32_t typeId, uint32_t matrixStride = 0) const
+            {
+                const SpirvId& type = id(typeId);
+                switch (type.opcode)
+                {
+                case spv::OpTypeInt:
+                case spv::OpTypeFloat:
+                    return type.operands[1] / 8;
+                case spv::OpTypeVector:
+                    return type.operands[2] * typeSize(type.operands[1]);
+                case spv::OpTypeMatrix:
+                    return type.operands[2] * (matrixStride != 0 ? matrixStride : typeSize(type.operands[1]));
+                case spv::OpTypeArray:
+                    return constant(type.operands[2]) * type.arrayStride.value_or(typeSize(type.operands[1]));
+                case spv::OpTypeStruct:
+                {
+                    uint32_t size = 0;
+                    for (size_t member = 1; member < type.operands.size(); member++)
+                    {
+                        size_t index = member - 1;
+                        uint32_t memberOffset = index < type.memberOffsets.size() ? type.memberOffsets[index] : 0;
+                        uint32_t memberStride = index < type.memberMatrixStrides.size() ? type.memberMatrixStrides[index] : 0;
+                        size = std::max(size, memberOffset + typeSize(type.operands[member], memberStride));
+                    }
+                    return size;
+                }
+                default:
+                    return 0;
+                }
+            }
+
+        private:
+            void parseInstruction(uint32_t opcode, const uint32_t* operands, uint32_t count)
+            {
+                switch (opcode)
+                {
+                case spv::OpEntryPoint:
+                    // The first entry point decides the stage
+                    if (m_stage == 0 && count > 0)
+                    {
+                        m_stage = executionModelStage(operands[0]);
+                    }
+                    break;
+                case spv::OpDecorate:
+                    if (count >= 2)
+                    {
+                        decorate(operands[0], operands[1], count >= 3 ? operands[2] : 0);
+                    }
+                    break;
+                case spv::OpMemberDecorate:
+                    if (count >= 4)
+                    {
+                        decorateMember(operands[0], operands[1], operands[2], operands[3]);
+                    }
+                    break;
+                case spv::OpTypeInt:
+                case spv::OpTypeFloat:
+                case spv::OpTypeVector:
+                case spv::OpTypeMatrix:
+                case spv::OpTypeImage:
+                case spv::OpTypeSampler:
+                case spv::OpTypeSampledImage:
+                case spv::OpTypeArray:
+                case spv::OpTypeRuntimeArray:
+                case spv::OpTypeStruct:
+                case spv::OpTypePointer:
+                    // Result id first
+                    store(operands[0], opcode, operands, count);
+                    break;
+                case spv::OpConstant:
+                case spv::OpVariable:
+                    // Result type, then result id
+                    if (count >= 2)
+                    {
+                        store(operands[1], opcode, operands, count);
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            void store(uint32_t index, uint32_t opcode, const uint32_t* operands, uint32_t count)
+            {
+                SpirvId& target = mutableId(index);
+                target.opcode = opcode;
+                target.operands.assign(operands, operands + count);
+            }
+
+            void decorate(uint32_t target, uint32_t decoration, uint32_t value)
+            {
+                SpirvId& decorated = mutableId(target);
+                switch (decoration)
+                {
+                case spv::DescriptorSet: decorated.set = value; break;
+                case spv::Binding: decorated.binding = value; break;
+                case spv::Location: decorated.location = value; break;
+                case spv::ArrayStride: decorated.arrayStride = value; break;
+                case spv::BuiltIn: decorated.builtIn = true; break;
+                case spv::Block: decorated.block = true; break;
+                case spv::BufferBlock: decorated.bufferBlock = true; break;
+                default: break;
+                }
+            }
+
+            void decorateMember(uint32_t target, uint32_t member, uint32_t decoration, uint32_t value)
+            {
+                SpirvId& decorated = mutableId(target);
+                std::vector<uint32_t>* values = nullptr;
+                switch (decoration)
+                {
+                case spv::Offset: values = &decorated.memberOffsets; break;
+                case spv::MatrixStride: values = &decorated.memberMatrixStrides; break;
+                case spv::BuiltIn: decorated.builtIn = true; return;
+                default: return;
+                }
+
+                if (values->size() <= member)
+                {
+                    values->resize(member + 1, 0);
+                }
+                (*values)[member] = value;
+            }
+
+            SpirvId& mutableId(uint32_t index)
+            {
+                if (index >= m_ids.size())
+                {
+                    throw std::runtime_error("Failed to reflect shader: SPIR-V id out of range!");
+                }
+                return m_ids[index];
+            }
+
+            static VkShaderStageFlagBits executionModelStage(uint32_t model)
+            {
+                switch (model)
+                {
+                case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+                case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+                case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+                case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+                case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+                case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+                default:
+                    throw std::runtime_error("Failed to reflect shader: unsupported execution model!");
+                }
+            }
+
+            std::vector<SpirvId> m_ids;
+            VkShaderStageFlagBits m_stage = static_cast<VkShaderStageFlagBits>(0);
+        };
+
+        std::optional<VkDescriptorType> descriptorType(const SpirvModule& module, const SpirvId& type, uint32_t storageClass)
+        {
+            switch (type.opcode)
+            {
+            case spv::OpTypeSampler:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case spv::OpTypeSampledImage:
+            {
+                const SpirvId& image = module.id(type.operands[1]);
+                return image.operands[2] == spv::DimBuffer
+                    ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
+                    : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            }
+            case spv::OpTypeImage:
+            {
+                // Sampled operand: 1 = used with a sampler, 2 = read/write
+                uint32_t dim = type.operands[2];
+                bool storage = type.operands[6] == 2;
+                if (dim == spv::DimSubpassData)
+                {
+                    return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                }
+                if (dim == spv::DimBuffer)
+                {
+                    return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                }
+                return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            }
+            case spv::OpTypeStruct:
+                if (storageClass == spv::StorageBuffer || type.bufferBlock)
+                {
+                    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                }
+                return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            default:
+                return std::nullopt;
+            }
+        }
+
+        std::optional<VkFormat> vertexFormat(const SpirvModule& module, const SpirvId& type)
+        {
+            uint32_t components = 1;
+            const SpirvId* scalar = &type;
+            if (type.opcode == spv::OpTypeVector)
+            {
+                components = type.operands[2];
+                scalar = &module.id(type.operands[1]);
+            }
+
+            // Only 32-bit inputs are used by the toys
+            if (scalar->operands.size() < 2 || scalar->operands[1] != 32)
+            {
+                return std::nullopt;
+            }
+
+            static constexpr VkFormat kFloat[] = { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+            static constexpr VkFormat kSint[] = { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+            static constexpr VkFormat kUint[] = { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+
+            if (components < 1 || components > 4)
+            {
+                return std::nullopt;
+            }
+            if (scalar->opcode == spv::OpTypeFloat)
+            {
+                return kFloat[components - 1];
+            }
+            if (scalar->opcode == spv::OpTypeInt)
+            {
+                return scalar->operands[2] ? kSint[components - 1] : kUint[components - 1];
+            }
+            return std::nullopt;
+        }
+    }
+
+    ShaderReflection::ShaderReflection(const uint32_t* code, size_t wordCount)
+    {
+        SpirvModule module(code, wordCount);
+        m_stages = module.stage();
+
+        std::optional<VkPushConstantRange> pushConstants;
+
+        for (uint32_t index = 0; index < module.idCount(); index++)
+        {
+            const SpirvId& variable = module.id(index);
+            if (variable.opcode != spv::OpVariable)
+            {
+                continue;
+            }
+
+            uint32_t storageClass = variable.operands[2];
+            const SpirvId& pointer = module.id(variable.operands[0]);
+            uint32_t typeId = pointer.operands[2];
+
+            if (storageClass == spv::PushConstant)
+            {
+                // Block members may start past 0 when stages share one block
+                const SpirvId& block = module.id(typeId);
+                uint32_t begin = block.memberOffsets.empty() ? 0
+                    : *std::min_element(block.memberOffsets.begin(), block.memberOffsets.end());
+                uint32_t end = module.typeSize(typeId);
+
+                pushConstants = VkPushConstantRange{ static_cast<VkShaderStageFlags>(m_stages), begin, end - begin };
+                continue;
+            }
+
+            if (storageClass == spv::Input && m_stages == VK_SHADER_STAGE_VERTEX_BIT)
+            {
+                if (variable.builtIn || !variable.location.has_value())
+                {
+                    continue;
+                }
+
+                const SpirvId& type = module.id(typeId);
+                // A matrix takes one location per column
+                uint32_t columns = type.opcode == spv::OpTypeMatrix ? type.operands[2] : 1;
+                const SpirvId& column = type.opcode == spv::OpTypeMatrix ? module.id(type.operands[1]) : type;
+
+                if (std::optional<VkFormat> format = vertexFormat(module, column))
+                {
+                    for (uint32_t i = 0; i < columns; i++)
+                    {
+                        m_vertexInputs.push_back({ *variable.location + i, *format });
+                    }
+                }
+                continue;
+            }
+
+            if (storageClass != spv::UniformConstant && storageClass != spv::Uniform && storageClass != spv::StorageBuffer)
+            {
+                continue;
+            }
+            if (!variable.set.has_value() || !variable.binding.has_value())
+            {
+                continue;
+            }
+
+            // Strip arrays of descriptors down to the element type
+            uint32_t count = 1;
+            const SpirvId* type = &module.id(typeId);
+            while (type->opcode == spv::OpTypeArray || type->opcode == spv::OpTypeRuntimeArray)
+            {
+                count = type->opcode == spv::OpTypeArray ? count * module.constant(type->operands[2]) : 0;
+                type = &module.id(type->operands[1]);
+            }
+
+            if (std::optional<VkDescriptorType> descriptor = descriptorType(module, *type, storageClass))
+            {
+                m_bindings.push_back({ *variable.set, *variable.binding, *descriptor, count, static_cast<VkShaderStageFlags>(m_stages) });
+            }
+        }
+
+        if (pushConstants.has_value())
+        {
+            m_pushConstantRanges.push_back(*pushConstants);
+        }
+
+        std::sort(m_bindings.begin(), m_bindings.end(), [](const ReflectedBinding& a, const ReflectedBinding& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+        std::sort(m_vertexInputs.begin(), m_vertexInputs.end(), [](const ReflectedVertexInput& a, const ReflectedVertexInput& b) {
+            return a.location < b.location;
+        });
+    }
+
+    ShaderReflection ShaderReflection::fromFile(const std::filesystem::path& spirvPath)
+    {
+        MappedFile file(spirvPath);
+        return ShaderReflection(file.words(), file.wordCount());
+    }
+
+    ShaderReflection& ShaderReflection::merge(const ShaderReflection& other)
+    {
+        m_stages |= other.m_stages;
+
+        for (const ReflectedBinding& binding : other.m_bindings)
+        {
+            auto it = std::find_if(m_bindings.begin(), m_bindings.end(), [&binding](const ReflectedBinding& existing) {
+                return existing.set == binding.set && existing.binding == binding.binding;
+            });
+
+            if (it == m_bindings.end())
+            {
+                m_bindings.push_back(binding);
+                continue;
+            }
+
+            if (it->type != binding.type)
+            {
+                throw std::runtime_error("Failed to merge shader reflection: set " + std::to_string(binding.set)
+                    + " binding " + std::to_string(binding.binding) + " has different types across stages!");
+            }
+            it->stages |= binding.stages;
+            it->count = (it->count == 0 || binding.count == 0) ? 0 : std::max(it->count, binding.count);
+        }
+
+        // One range covering every stage's block, pushed with all their flags
+        for (const VkPushConstantRange& range : other.m_pushConstantRanges)
+        {
+            if (m_pushConstantRanges.empty())
+            {
+                m_pushConstantRanges.push_back(range);
+                continue;
+            }
+
+            VkPushConstantRange& merged = m_pushConstantRanges.front();
+            uint32_t end = std::max(merged.offset + merged.size, range.offset + range.size);
+            merged.offset = std::min(merged.offset, range.offset);
+            merged.size = end - merged.offset;
+            merged.stageFlags |= range.stageFlags;
+        }
+
+        if (m_vertexInputs.empty())
+        {
+            m_vertexInputs = other.m_vertexInputs;
+        }
+
+        std::sort(m_bindings.begin(), m_bindings.end(), [](const ReflectedBinding& a, const ReflectedBinding& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+
+        return *this;
+    }
+
+    uint32_t ShaderReflection::setCount() const
+    {
+        uint32_t count = 0;
+        for (const ReflectedBinding& binding : m_bindings)
+        {
+            count = std::max(count, binding.set + 1);
+        }
+        return count;
+    }
+
+    bool ShaderReflection::hasSameLayout(const ShaderReflection& other) const
+    {
+        auto sameBinding = [](const ReflectedBinding& a, const ReflectedBinding& b) {
+            return a.set == b.set && a.binding == b.binding && a.type == b.type
+                && a.count == b.count && a.stages == b.stages;
+        };
+        auto sameRange = [](const VkPushConstantRange& a, const VkPushConstantRange& b) {
+            return a.stageFlags == b.stageFlags && a.offset == b.offset && a.size == b.size;
+        };
+
+        return std::equal(m_bindings.begin(), m_bindings.end(), other.m_bindings.begin(), other.m_bindings.end(), sameBinding)
+            && std::equal(m_pushConstantRanges.begin(), m_pushConstantRanges.end(),
+                other.m_pushConstantRanges.begin(), other.m_pushConstantRanges.end(), sameRange);
+    }
+
+    std::vector<VkDescriptorSetLayoutBinding> ShaderReflection::layoutBindings(
+        uint32_t set,
+        const std::vector<uint32_t>& dynamicBindings,
+        uint32_t runtimeArrayCount) const
+    {
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+
+        for (const ReflectedBinding& binding : m_bindings)
+        {
+            if (binding.set != set)
+            {
+                continue;
+            }
+
+            VkDescriptorType type = binding.type;
+            bool isDynamic = std::find(dynamicBindings.begin(), dynamicBindings.end(), binding.binding) != dynamicBindings.end();
+            if (isDynamic && type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+            {
+                type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            }
+            else if (isDynamic && type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+            {
+                type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            }
+
+            VkDescriptorSetLayoutBinding layoutBinding{};
+            layoutBinding.binding = binding.binding;
+            layoutBinding.descriptorType = type;
+            layoutBinding.descriptorCount = binding.count == 0 ? runtimeArrayCount : binding.count;
+            layoutBinding.stageFlags = binding.stages;
+            layoutBindings.push_back(layoutBinding);
+        }
+
+        return layoutBindings;
+    }
+
+    void ShaderReflection::validateVertexInput(const std::vector<VkVertexInputAttributeDescription>& attributes) const
+    {
+        for (const ReflectedVertexInput& input : m_vertexInputs)
+        {
+            auto it = std::find_if(attributes.begin(), attributes.end(), [&input](const VkVertexInputAttributeDescription& attribute) {
+                return attribute.location == input.location;
+            });
+
+            if (it == attributes.end() || it->format != input.format)
+            {
+                throw std::runtime_error("Failed to validate vertex input: location "
+                    + std::to_string(input.location) + " does not match the vertex attributes!");
+            }
+        }
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,76 @@
+#ifndef SHADER_REFLECTION_H
+#define SHADER_REFLECTION_H
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace vkcommon
+{
+    struct ReflectedBinding
+    {
+        uint32_t set;
+        uint32_t binding;
+        VkDescriptorType type;
+        uint32_t count;             // 0 for runtime-sized arrays
+        VkShaderStageFlags stages;
+    };
+
+    struct ReflectedVertexInput
+    {
+        uint32_t location;
+        VkFormat format;
+    };
+
+    // Descriptor bindings, push constant ranges and vertex inputs read from
+    // SPIR-V, so layouts follow the shaders instead of being written by hand.
+    // Reflect each stage, then merge() the stages of one pipeline; bindings
+    // used by several stages end up with exactly those stages' flags.
+    class ShaderReflection
+    {
+    public:
+        ShaderReflection() = default;
+
+        // Throws if the code is not valid SPIR-V
+        ShaderReflection(const uint32_t* code, size_t wordCount);
+
+        static ShaderReflection fromFile(const std::filesystem::path& spirvPath);
+
+        // Throws if both stages declare the same binding with different types
+        ShaderReflection& merge(const ShaderReflection& other);
+
+        VkShaderStageFlags stages() const { return m_stages; }
+        const std::vector<ReflectedBinding>& bindings() const { return m_bindings; }
+        const std::vector<VkPushConstantRange>& pushConstantRanges() const { return m_pushConstantRanges; }
+        // Vertex stage only
+        const std::vector<ReflectedVertexInput>& vertexInputs() const { return m_vertexInputs; }
+
+        // One past the highest set used
+        uint32_t setCount() const;
+
+        // Same bindings and push constant ranges, so one pipeline layout fits both
+        bool hasSameLayout(const ShaderReflection& other) const;
+
+        // Uniform and storage buffers listed in dynamicBindings become their
+        // _DYNAMIC variants, runtime-sized arrays get runtimeArrayCount descriptors
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings(
+            uint32_t set,
+            const std::vector<uint32_t>& dynamicBindings = {},
+            uint32_t runtimeArrayCount = 1) const;
+
+        // Throws unless every vertex input has an attribute at its location
+        // with the same format
+        void validateVertexInput(const std::vector<VkVertexInputAttributeDescription>& attributes) const;
+
+    private:
+        std::vector<ReflectedBinding> m_bindings;
+        std::vector<VkPushConstantRange> m_pushConstantRanges;
+        std::vector<ReflectedVertexInput> m_vertexInputs;
+        VkShaderStageFlags m_stages{ 0 };
+    };
+
+} // namespace vkcommon
+
+#endif // SHADER_REFLECTION_H
@@ -0,0 +1,136 @@
+#include "shader_watcher.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace vkcommon
+{
+
+    namespace
+    {
+        bool isSpirv(const std::filesystem::path& path)
+        {
+            return path.extension() == ".spv";
+        }
+    }
+
+#ifdef __linux__
+
+    ShaderWatcher::ShaderWatcher(const std::filesystem::path& directory)
+        : m_directory(directory)
+    {
+        m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_inotify < 0)
+        {
+            throw std::runtime_error("Failed to initialize inotify!");
+        }
+
+        // Compilers either write in place or rename a finished file over the old one
+        if (inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            close(m_inotify);
+            throw std::runtime_error("Failed to watch shader directory: " + directory.string());
+        }
+    }
+
+    ShaderWatcher::~ShaderWatcher()
+    {
+        if (m_inotify >= 0)
+        {
+            close(m_inotify);
+        }
+    }
+
+    std::vector<std::filesystem::path> ShaderWatcher::poll()
+    {
+        std::vector<std::filesystem::path> changed;
+
+        alignas(inotify_event) char buffer[4096];
+        for (;;)
+        {
+            ssize_t length = read(m_inotify, buffer, sizeof(buffer));
+            if (length <= 0)
+            {
+                // EAGAIN: no more events queued
+                break;
+            }
+
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                if (event->len == 0)
+                {
+                    continue;
+                }
+
+                std::filesystem::path path = m_directory / event->name;
+                if (isSpirv(path) && std::find(changed.begin(), changed.end(), path) == changed.end())
+                {
+                    changed.push_back(std::move(path));
+                }
+            }
+        }
+
+        return changed;
+    }
+
+#else
+
+    ShaderWatcher::ShaderWatcher(const std::filesystem::path& directory)
+        : m_directory(directory)
+    {
+        if (!std::filesystem::is_directory(directory))
+        {
+            throw std::runtime_error("Failed to watch shader directory: " + directory.string());
+        }
+
+        m_writeTimes = scan();
+    }
+
+    ShaderWatcher::~ShaderWatcher() = default;
+
+    std::vector<std::filesystem::path> ShaderWatcher::poll()
+    {
+        std::vector<std::filesystem::path> changed;
+
+        auto writeTimes = scan();
+        for (const auto& [path, writeTime] : writeTimes)
+        {
+            auto it = m_writeTimes.find(path);
+            if (it == m_writeTimes.end() || it->second != writeTime)
+            {
+                changed.push_back(path);
+            }
+        }
+
+        m_writeTimes = std::move(writeTimes);
+        return changed;
+    }
+
+    std::map<std::filesystem::path, std::filesystem::file_time_type> ShaderWatcher::scan() const
+    {
+        std::map<std::filesystem::path, std::filesystem::file_time_type> writeTimes;
+
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(m_directory, error))
+        {
+            if (entry.is_regular_file(error) && isSpirv(entry.path()))
+            {
+                writeTimes[entry.path()] = entry.last_write_time(error);
+            }
+        }
+
+        return writeTimes;
+    }
+
+#endif
+
+} // namespace vkcommon
@@ -0,0 +1,40 @@
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include <filesystem>
+#include <map>
+#include <vector>
+
+namespace vkcommon
+{
+    // Reports .spv files written into a directory, e.g. the toy's shader
+    // output directory while shaders are rebuilt. Uses inotify on Linux and
+    // compares modification times on other platforms.
+    class ShaderWatcher
+    {
+    public:
+        // Throws if the directory cannot be watched
+        explicit ShaderWatcher(const std::filesystem::path& directory);
+        ~ShaderWatcher();
+
+        ShaderWatcher(const ShaderWatcher&) = delete;
+        ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+        // Files changed since the last call, each listed once; never blocks
+        std::vector<std::filesystem::path> poll();
+
+        const std::filesystem::path& directory() const { return m_directory; }
+
+    private:
+        std::filesystem::path m_directory;
+#ifdef __linux__
+        int m_inotify{ -1 };
+#else
+        std::map<std::filesystem::path, std::filesystem::file_time_type> m_writeTimes;
+        std::map<std::filesystem::path, std::filesystem::file_time_type> scan() const;
+#endif
+    };
+
+} // namespace vkcommon
+
+#endif // SHADER_WATCHER_H
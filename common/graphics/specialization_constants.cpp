@@ -0,0 +1,72 @@
+#include "specialization_constants.h"
+
+#include <algorithm>
+
+namespace vkcommon
+{
+
+    VkSpecializationInfo SpecializationConstants::info() const
+    {
+        VkSpecializationInfo info{};
+        info.mapEntryCount = static_cast<uint32_t>(m_entries.size());
+        info.pMapEntries = m_entries.data();
+        info.dataSize = m_data.size();
+        info.pData = m_data.data();
+        return info;
+    }
+
+    bool SpecializationConstants::operator==(const SpecializationConstants& other) const
+    {
+        auto sameEntry = [](const VkSpecializationMapEntry& a, const VkSpecializationMapEntry& b) {
+            return a.constantID == b.constantID && a.offset == b.offset && a.size == b.size;
+        };
+
+        return std::equal(m_entries.begin(), m_entries.end(), other.m_entries.begin(), other.m_entries.end(), sameEntry)
+            && m_data == other.m_data;
+    }
+
+    void SpecializationConstants::setBytes(uint32_t constantId, const void* data, size_t size)
+    {
+        auto it = std::lower_bound(m_entries.begin(), m_entries.end(), constantId,
+            [](const VkSpecializationMapEntry& entry, uint32_t id) { return entry.constantID < id; });
+
+        const auto* bytes = static_cast<const uint8_t*>(data);
+
+        if (it != m_entries.end() && it->constantID == constantId && it->size == size)
+        {
+            std::copy(bytes, bytes + size, m_data.begin() + it->offset);
+            return;
+        }
+
+        // New constant or a different type: repack the data in id order
+        std::vector<VkSpecializationMapEntry> entries;
+        std::vector<uint8_t> packed;
+        bool inserted = false;
+
+        auto append = [&entries, &packed](uint32_t id, const uint8_t* value, size_t valueSize) {
+            entries.push_back({ id, static_cast<uint32_t>(packed.size()), valueSize });
+            packed.insert(packed.end(), value, value + valueSize);
+        };
+
+        for (const VkSpecializationMapEntry& entry : m_entries)
+        {
+            if (!inserted && entry.constantID >= constantId)
+            {
+                append(constantId, bytes, size);
+                inserted = true;
+            }
+            if (entry.constantID != constantId)
+            {
+                append(entry.constantID, m_data.data() + entry.offset, entry.size);
+            }
+        }
+        if (!inserted)
+        {
+            append(constantId, bytes, size);
+        }
+
+        m_entries = std::move(entries);
+        m_data = std::move(packed);
+    }
+
+} // namespace vkcommon
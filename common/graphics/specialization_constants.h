@@ -0,0 +1,55 @@
+#ifndef SPECIALIZATION_CONSTANTS_H
+#define SPECIALIZATION_CONSTANTS_H
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace vkcommon
+{
+    // Values for a shader's `layout(constant_id = N) const` declarations,
+    // baked in when the pipeline is compiled so the driver can fold branches
+    // and drop unused fetches. Constants are kept ordered by id, so the same
+    // set of values always produces the same VkSpecializationInfo.
+    class SpecializationConstants
+    {
+    public:
+        // bool is stored as VkBool32, matching GLSL's `const bool`
+        template <typename T>
+        SpecializationConstants& set(uint32_t constantId, T value)
+        {
+            static_assert(std::is_same_v<T, bool> || std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>
+                || std::is_same_v<T, float> || std::is_same_v<T, double>,
+                "Specialization constants are bool, int, uint, float or double");
+
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                VkBool32 bits = value ? VK_TRUE : VK_FALSE;
+                setBytes(constantId, &bits, sizeof(bits));
+            }
+            else
+            {
+                setBytes(constantId, &value, sizeof(value));
+            }
+            return *this;
+        }
+
+        bool empty() const { return m_entries.empty(); }
+
+        // Points into this object, valid until it changes or is destroyed
+        VkSpecializationInfo info() const;
+
+        bool operator==(const SpecializationConstants& other) const;
+
+    private:
+        void setBytes(uint32_t constantId, const void* data, size_t size);
+
+        std::vector<VkSpecializationMapEntry> m_entries;
+        std::vector<uint8_t> m_data;
+    };
+
+} // namespace vkcommon
+
+#endif // SPECIALIZATION_CONSTANTS_H
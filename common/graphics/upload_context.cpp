@@ -0,0 +1,363 @@
+#include "upload_context.h"
+
+#include "core/device.h"
+#include "core/physical_device.h"
+#include "resources/buffers/buffer.h"
+#include "resources/images/image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace vkcommon
+{
+    namespace
+    {
+        // Every way an uploaded buffer is read: vertex and index fetch, shaders
+        // of any graphics or compute stage and indirect draw parameters
+        constexpr VkPipelineStageFlags kBufferReadStages =
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        constexpr VkAccessFlags kBufferReadAccess =
+            VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+            VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    }
+
+    UploadContext::UploadContext(const PhysicalDevice& physicalDevice, const Device& device, MemoryAllocator& allocator,
+        VkDeviceSize stagingSize)
+        : m_deviceRef(device)
+        , m_allocatorRef(allocator)
+        , m_graphicsPool(physicalDevice, device)
+        , m_stagingRing(device, allocator)
+    {
+        m_dedicatedTransfer = device.hasDedicatedTransferQueue();
+        if (m_dedicatedTransfer)
+        {
+            m_transferPool = std::make_unique<CommandPool>(device, device.transferQueueFamily());
+        }
+
+        // Buffer to image copies need offsets aligned to the texel size, 16 covers every format used here
+        m_stagingAlignment = std::max<VkDeviceSize>(
+            m_stagingAlignment, physicalDevice.properties().limits.optimalBufferCopyOffsetAlignment);
+
+        m_stagingRing.create(stagingSize);
+
+        // Leave room for several chunks in flight so large uploads still overlap
+        m_chunkSize = stagingSize / 4;
+    }
+
+    UploadContext::~UploadContext()
+    {
+        waitIdle();
+    }
+
+    UploadContext::UploadBatch UploadContext::acquireBatch()
+    {
+        retireCompleted();
+
+        if (!m_freeBatches.empty())
+        {
+            UploadBatch batch = std::move(m_freeBatches.back());
+            m_freeBatches.pop_back();
+            batch.fence.reset();
+            return batch;
+        }
+
+        VkCommandBuffer graphicsCommandBuffer = m_graphicsPool.allocateSingleBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        if (!m_dedicatedTransfer)
+        {
+            return UploadBatch{ graphicsCommandBuffer, graphicsCommandBuffer, Fence{ m_deviceRef, false }, std::nullopt, 0 };
+        }
+
+        return UploadBatch{
+            m_transferPool->allocateSingleBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY),
+            graphicsCommandBuffer,
+            Fence{ m_deviceRef, false },
+            Semaphore{ m_deviceRef },
+            0 };
+    }
+
+    void UploadContext::retireCompleted()
+    {
+        // The fence is on the graphics submission, which waits for the transfer one,
+        // and batches are submitted in order so they also complete in order
+        while (!m_inFlight.empty() && m_inFlight.front().fence.signaled())
+        {
+            UploadBatch batch = std::move(m_inFlight.front());
+            m_inFlight.pop_front();
+
+            m_lastCompleted = batch.ticket;
+            vkResetCommandBuffer(batch.graphicsCommandBuffer, 0);
+            if (m_dedicatedTransfer)
+            {
+                vkResetCommandBuffer(batch.transferCommandBuffer, 0);
+            }
+            m_freeBatches.push_back(std::move(batch));
+        }
+
+        m_stagingRing.release(m_lastCompleted);
+    }
+
+    UploadContext::UploadBatch& UploadContext::recording()
+    {
+        if (!m_recording)
+        {
+            m_recording.emplace(acquireBatch());
+            m_graphicsPool.beginCommandBuffer(m_recording->graphicsCommandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            if (m_dedicatedTransfer)
+            {
+                m_transferPool->beginCommandBuffer(m_recording->transferCommandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            }
+        }
+        return *m_recording;
+    }
+
+    VkCommandBuffer UploadContext::transferCommandBuffer()
+    {
+        return recording().transferCommandBuffer;
+    }
+
+    VkCommandBuffer UploadContext::graphicsCommandBuffer()
+    {
+        return recording().graphicsCommandBuffer;
+    }
+
+    VkDeviceSize UploadContext::allocateStaging(VkDeviceSize size)
+    {
+        while (true)
+        {
+            if (auto offset = m_stagingRing.allocate(size, m_stagingAlignment))
+            {
+                return *offset;
+            }
+
+            // Ring is full: submit what was staged so far and reclaim the oldest batch
+            flush();
+            if (m_inFlight.empty())
+            {
+                throw std::runtime_error("Failed to allocate staging memory, upload larger than the staging ring!");
+            }
+
+            m_inFlight.front().fence.wait();
+            retireCompleted();
+        }
+    }
+
+    void UploadContext::uploadBuffer(const Buffer& dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+    {
+        const char* src = static_cast<const char*>(data);
+
+        for (VkDeviceSize done = 0; done < size;)
+        {
+            VkDeviceSize chunk = std::min(size - done, m_chunkSize);
+            VkDeviceSize offset = allocateStaging(chunk);
+            memcpy(m_stagingRing.mapped(offset), src + done, chunk);
+
+            // Fetch the command buffer after staging, allocating may have flushed the batch
+            VkBufferCopy copyRegion{};
+            copyRegion.srcOffset = offset;
+            copyRegion.dstOffset = dstOffset + done;
+            copyRegion.size = chunk;
+            vkCmdCopyBuffer(transferCommandBuffer(), m_stagingRing.buffer(), dst.handle(), 1, &copyRegion);
+
+            done += chunk;
+        }
+
+        transferOwnership(dst);
+    }
+
+    void UploadContext::uploadImage(Image& dst, const void* pixels, uint32_t width, uint32_t height, uint32_t texelSize)
+    {
+        const char* src = static_cast<const char*>(pixels);
+        VkDeviceSize rowPitch = static_cast<VkDeviceSize>(width) * texelSize;
+
+        // Chunks are whole rows so each one is a single buffer to image copy
+        uint32_t rowsPerChunk = static_cast<uint32_t>(std::max<VkDeviceSize>(1, m_chunkSize / rowPitch));
+
+        for (uint32_t row = 0; row < height;)
+        {
+            uint32_t rows = std::min(rowsPerChunk, height - row);
+            VkDeviceSize chunk = rowPitch * rows;
+            VkDeviceSize offset = allocateStaging(chunk);
+            memcpy(m_stagingRing.mapped(offset), src + rowPitch * row, chunk);
+
+            dst.copyFromBuffer(m_stagingRing.buffer(), offset, width, rows, row, *this);
+
+            row += rows;
+        }
+
+        transferOwnership(dst);
+    }
+
+    void UploadContext::transferOwnership(const Buffer& buffer)
+    {
+        if (!m_dedicatedTransfer)
+        {
+            return;
+        }
+
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = m_deviceRef.transferQueueFamily();
+        barrier.dstQueueFamilyIndex = m_deviceRef.graphicsQueueFamily();
+        barrier.buffer = buffer.handle();
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+
+        // Release on the transfer queue
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(transferCommandBuffer(),
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr,
+            1, &barrier,
+            0, nullptr);
+
+        // Acquire on the graphics queue
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = kBufferReadAccess;
+        vkCmdPipelineBarrier(graphicsCommandBuffer(),
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            kBufferReadStages,
+            0,
+            0, nullptr,
+            1, &barrier,
+            0, nullptr);
+    }
+
+    void UploadContext::transferOwnership(const Image& image)
+    {
+        if (!m_dedicatedTransfer)
+        {
+            return;
+        }
+
+        // Layout is left as is, graphics-side work such as mip generation continues from it
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = m_deviceRef.transferQueueFamily();
+        barrier.dstQueueFamilyIndex = m_deviceRef.graphicsQueueFamily();
+        barrier.image = image.handle();
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = image.mipLevels();
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        // Release on the transfer queue
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(transferCommandBuffer(),
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+
+        // Acquire on the graphics queue
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(graphicsCommandBuffer(),
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+    }
+
+    UploadTicket UploadContext::flush()
+    {
+        if (!m_recording)
+        {
+            return m_lastSubmitted;
+        }
+
+        UploadBatch batch = std::move(*m_recording);
+        m_recording.reset();
+
+        // Make transfer writes visible to any later use on the graphics queue
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = kBufferReadAccess;
+
+        vkCmdPipelineBarrier(batch.graphicsCommandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            kBufferReadStages,
+            0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+        VkSemaphore transferComplete = VK_NULL_HANDLE;
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+        if (m_dedicatedTransfer)
+        {
+            m_transferPool->endCommandBuffer(batch.transferCommandBuffer);
+            transferComplete = batch.transferComplete->handle();
+
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &batch.transferCommandBuffer;
+            submitInfo.signalSemaphoreCount = 1;
+            submitInfo.pSignalSemaphores = &transferComplete;
+
+            if (vkQueueSubmit(m_deviceRef.transferQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to submit transfer command buffer!");
+            }
+
+            // The graphics half waits for the copies, the acquire barriers come first in it
+            submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.waitSemaphoreCount = 1;
+            submitInfo.pWaitSemaphores = &transferComplete;
+            submitInfo.pWaitDstStageMask = &waitStage;
+        }
+
+        m_graphicsPool.endCommandBuffer(batch.graphicsCommandBuffer);
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.graphicsCommandBuffer;
+
+        if (vkQueueSubmit(m_deviceRef.graphicsQueue(), 1, &submitInfo, batch.fence.handle()) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to submit upload command buffer!");
+        }
+
+        batch.ticket = ++m_lastSubmitted;
+        m_stagingRing.close(batch.ticket);
+        m_inFlight.push_back(std::move(batch));
+
+        return m_lastSubmitted;
+    }
+
+    bool UploadContext::isComplete(UploadTicket ticket)
+    {
+        retireCompleted();
+        return ticket <= m_lastCompleted;
+    }
+
+    void UploadContext::wait(UploadTicket ticket)
+    {
+        for (const auto& batch : m_inFlight)
+        {
+            if (batch.ticket > ticket)
+            {
+                break;
+            }
+            batch.fence.wait();
+        }
+        retireCompleted();
+    }
+
+    void UploadContext::waitIdle()
+    {
+        wait(flush());
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef UPLOAD_CONTEXT_H
+#define UPLOAD_CONTEXT_H
+
+#include <vulkan/vulkan.h>
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "graphics/command_pool.h"
+#include "resources/buffers/staging_ring.h"
+#include "sync/fence.h"
+#include "sync/semaphore.h"
+
+namespace vkcommon
+{
+    class PhysicalDevice;
+    class Device;
+    class MemoryAllocator;
+    class Buffer;
+    class Image;
+
+    // Monotonic id of a submitted upload batch
+    using UploadTicket = uint64_t;
+
+    // Collects copies, layout transitions and mip generation into one command
+    // buffer and submits them together with a fence instead of stalling the
+    // queue after every resource. Source data goes through a fixed-size
+    // StagingRing; uploads larger than a chunk are split across submissions.
+    //
+    // When the device has a transfer-only queue family, copies are recorded on
+    // it and each finished resource is released to the graphics family. The
+    // matching acquire, and any work that needs a graphics queue (blits,
+    // shader-stage barriers), goes into a second command buffer that waits on
+    // the transfer submission. Without one, both command buffers are the same.
+    class UploadContext
+    {
+    public:
+        static constexpr VkDeviceSize kDefaultStagingSize = 32ull * 1024 * 1024;
+
+        UploadContext(const PhysicalDevice& physicalDevice, const Device& device, MemoryAllocator& allocator,
+            VkDeviceSize stagingSize = kDefaultStagingSize);
+        ~UploadContext();
+
+        UploadContext(const UploadContext&) = delete;
+        UploadContext& operator=(const UploadContext&) = delete;
+
+        // Command buffers of the batch being recorded, begun on first use
+        VkCommandBuffer transferCommandBuffer();
+        VkCommandBuffer graphicsCommandBuffer();
+
+        // Stage data and record a copy into dst
+        void uploadBuffer(const Buffer& dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+        // Stage tightly packed texels and copy them into mip 0 of dst, which
+        // must already be in TRANSFER_DST_OPTIMAL layout
+        void uploadImage(Image& dst, const void* pixels, uint32_t width, uint32_t height, uint32_t texelSize);
+
+        // Hand a resource written on the transfer queue over to the graphics
+        // family; no-op without a dedicated transfer queue
+        void transferOwnership(const Buffer& buffer);
+        void transferOwnership(const Image& image);
+
+        // Submit everything recorded so far; returns the ticket of the last batch
+        UploadTicket flush();
+
+        bool isComplete(UploadTicket ticket);
+        void wait(UploadTicket ticket);
+        void waitIdle();
+
+    private:
+        struct UploadBatch
+        {
+            VkCommandBuffer transferCommandBuffer;
+            VkCommandBuffer graphicsCommandBuffer;
+            Fence fence;
+            std::optional<Semaphore> transferComplete; // Only with a dedicated transfer queue
+            UploadTicket ticket;
+        };
+
+        UploadBatch acquireBatch();
+        void retireCompleted();
+        UploadBatch& recording();
+
+        // Offset of size bytes in the staging ring, submitting and waiting on
+        // earlier batches until enough of the ring has been freed
+        VkDeviceSize allocateStaging(VkDeviceSize size);
+
+        const Device& m_deviceRef;
+        MemoryAllocator& m_allocatorRef;
+
+        CommandPool m_graphicsPool;
+        std::unique_ptr<CommandPool> m_transferPool;
+        bool m_dedicatedTransfer{ false };
+
+        StagingRing m_stagingRing;
+        VkDeviceSize m_stagingAlignment{ 16 };
+        VkDeviceSize m_chunkSize{ 0 };
+
+        std::optional<UploadBatch> m_recording;
+        std::deque<UploadBatch> m_inFlight;
+        std::vector<UploadBatch> m_freeBatches;
+
+        UploadTicket m_lastSubmitted{ 0 };
+        UploadTicket m_lastCompleted{ 0 };
+    };
+}
+
+#endif // UPLOAD_CONTEXT_H
@@ -1,9 +1,10 @@
 #include "buffer.h"
 
 #include "core/device.h"
-#include "graphics/command_pool.h"
+#include "graphics/upload_context.h"
 #include "resources/memory/memory_allocator.h"
 
+#include <cstring>
 #include <stdexcept>
 
 namespace vkcommon {
@@ -23,10 +24,7 @@ namespace vkcommon {
             m_buffer = VK_NULL_HANDLE;
         }
 
-        if (m_memory != VK_NULL_HANDLE) {
-            m_allocatorRef.freeMemory(m_memory);
-            m_memory = VK_NULL_HANDLE;
-        }
+        m_allocatorRef.free(m_allocation);
 
         m_size = 0;
     }
@@ -35,10 +33,10 @@ namespace vkcommon {
         : m_deviceRef(other.m_deviceRef)
         , m_allocatorRef(other.m_allocatorRef)
         , m_buffer(other.m_buffer)
-        , m_memory(other.m_memory)
+        , m_allocation(other.m_allocation)
         , m_size(other.m_size) {
         other.m_buffer = VK_NULL_HANDLE;
-        other.m_memory = VK_NULL_HANDLE;
+        other.m_allocation = {};
         other.m_size = 0;
     }
 
@@ -47,11 +45,11 @@ namespace vkcommon {
             cleanup();
 
             m_buffer = other.m_buffer;
-            m_memory = other.m_memory;
+            m_allocation = other.m_allocation;
             m_size = other.m_size;
 
             other.m_buffer = VK_NULL_HANDLE;
-            other.m_memory = VK_NULL_HANDLE;
+            other.m_allocation = {};
             other.m_size = 0;
         }
         return *this;
@@ -73,40 +71,42 @@ namespace vkcommon {
         VkMemoryRequirements memoryRequirements;
         vkGetBufferMemoryRequirements(m_deviceRef.handle(), m_buffer, &memoryRequirements);
 
-        m_memory = m_allocatorRef.allocateMemoryForRequirements(memoryRequirements, properties);
+        m_allocation = m_allocatorRef.allocate(memoryRequirements, properties);
         m_size = size;
 
-        vkBindBufferMemory(m_deviceRef.handle(), m_buffer, m_memory, 0);
+        vkBindBufferMemory(m_deviceRef.handle(), m_buffer, m_allocation.memory, m_allocation.offset);
     }
 
-    void Buffer::copyFrom(const Buffer& srcBuffer, VkDeviceSize size, const CommandPool& cmdPool)
+    void Buffer::copyFrom(const Buffer& srcBuffer, VkDeviceSize size, UploadContext& uploadContext)
     {
-
-        VkCommandBuffer commandBuffer = cmdPool.beginSingleTimeCommand();
-
         VkBufferCopy copyRegion{};
         copyRegion.size = size;
-        vkCmdCopyBuffer(commandBuffer, srcBuffer.handle(), m_buffer, 1, &copyRegion);
-
-        cmdPool.endSingleTimeCommand(commandBuffer, m_deviceRef.graphicsQueue());
+        vkCmdCopyBuffer(uploadContext.transferCommandBuffer(), srcBuffer.handle(), m_buffer, 1, &copyRegion);
+        uploadContext.transferOwnership(*this);
     }
 
     void Buffer::copyTo(void* data, VkDeviceSize size) const {
-        void* mapped;
-        if (vkMapMemory(m_deviceRef.handle(), m_memory, 0, size, 0, &mapped) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to map memory");
+        if (m_allocation.mapped == nullptr) {
+            throw std::runtime_error("Failed to read buffer: memory is not host visible");
         }
-        memcpy(data, mapped, size);
-        vkUnmapMemory(m_deviceRef.handle(), m_memory);
+        invalidate(size);
+        memcpy(data, m_allocation.mapped, size);
     }
 
     void Buffer::update(const void* data, VkDeviceSize size, VkDeviceSize offset) {
-        void* mapped;
-        if (vkMapMemory(m_deviceRef.handle(), m_memory, offset, size, 0, &mapped) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to map memory");
+        if (m_allocation.mapped == nullptr) {
+            throw std::runtime_error("Failed to update buffer: memory is not host visible");
         }
-        memcpy(mapped, data, size);
-        vkUnmapMemory(m_deviceRef.handle(), m_memory);
+        memcpy(static_cast<char*>(m_allocation.mapped) + offset, data, size);
+        flush(size, offset);
+    }
+
+    void Buffer::flush(VkDeviceSize size, VkDeviceSize offset) const {
+        m_allocatorRef.flush(m_allocation, offset, size);
+    }
+
+    void Buffer::invalidate(VkDeviceSize size, VkDeviceSize offset) const {
+        m_allocatorRef.invalidate(m_allocation, offset, size);
     }
 
-} //namespace vkcommon
\ No newline at end of file
+} //namespace vkcommon
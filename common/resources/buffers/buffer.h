@@ -2,10 +2,12 @@
 #define BUFFER_H
 #include <vulkan/vulkan_core.h>
 
+#include "resources/memory/memory_allocator.h"
+
 namespace vkcommon {
 
     class Device;
-    class CommandPool;
+    class UploadContext;
     class MemoryAllocator;
 
     class Buffer
@@ -26,13 +28,21 @@ namespace vkcommon {
             VkBufferUsageFlags usage,
             VkMemoryPropertyFlags properties);
 
-        void copyFrom(const Buffer& srcBuffer, VkDeviceSize size, const CommandPool& cmdPool);
+        void copyFrom(const Buffer& srcBuffer, VkDeviceSize size, UploadContext& uploadContext);
         void copyTo(void* data, VkDeviceSize size) const;
         void update(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
 
+        // Make host writes visible to the device / device writes visible to the host.
+        // Only needed when writing through mapped() on non-coherent memory.
+        void flush(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0) const;
+        void invalidate(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0) const;
+
         VkBuffer handle() const { return m_buffer; }
-        VkDeviceMemory memory() const { return m_memory; }
+        VkDeviceMemory memory() const { return m_allocation.memory; }
+        VkDeviceSize memoryOffset() const { return m_allocation.offset; }
         VkDeviceSize size() const { return m_size; }
+        // Persistently mapped pointer for host-visible buffers, nullptr otherwise
+        void* mapped() const { return m_allocation.mapped; }
 
     protected:
         const Device& m_deviceRef;
@@ -42,7 +52,7 @@ namespace vkcommon {
         void cleanup();
 
         VkBuffer m_buffer{ VK_NULL_HANDLE };
-        VkDeviceMemory m_memory{ VK_NULL_HANDLE };
+        Allocation m_allocation{};
         VkDeviceSize m_size{ 0 };
 
     };
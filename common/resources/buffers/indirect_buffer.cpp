@@ -0,0 +1,52 @@
+#include "indirect_buffer.h"
+
+#include "core/device.h"
+#include "graphics/upload_context.h"
+
+namespace vkcommon {
+
+    IndirectBuffer::IndirectBuffer(const Device& device, MemoryAllocator& allocator)
+        : m_deviceRef(device)
+        , m_buffer(device, allocator) {
+    }
+
+    void IndirectBuffer::create(const std::vector<VkDrawIndexedIndirectCommand>& commands,
+        UploadContext& uploadContext,
+        VkBufferUsageFlags extraUsage) {
+        m_commandCount = static_cast<uint32_t>(commands.size());
+        VkDeviceSize bufferSize = sizeof(VkDrawIndexedIndirectCommand) * commands.size();
+
+        m_buffer.create(
+            bufferSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | extraUsage,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+
+        uploadContext.uploadBuffer(m_buffer, commands.data(), bufferSize);
+    }
+
+    void IndirectBuffer::draw(VkCommandBuffer commandBuffer, uint32_t firstCommand, uint32_t count) const {
+        VkDeviceSize offset = static_cast<VkDeviceSize>(firstCommand) * kStride;
+
+        if (m_deviceRef.enabledFeatures().multiDrawIndirect) {
+            vkCmdDrawIndexedIndirect(commandBuffer, m_buffer.handle(), offset, count, kStride);
+            return;
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            vkCmdDrawIndexedIndirect(commandBuffer, m_buffer.handle(), offset + i * kStride, 1, kStride);
+        }
+    }
+
+    void IndirectBuffer::drawCount(VkCommandBuffer commandBuffer,
+        VkBuffer countBuffer,
+        VkDeviceSize countOffset,
+        uint32_t firstCommand,
+        uint32_t maxCount) const {
+        VkDeviceSize offset = static_cast<VkDeviceSize>(firstCommand) * kStride;
+
+        vkCmdDrawIndexedIndirectCount(commandBuffer, m_buffer.handle(), offset,
+            countBuffer, countOffset, maxCount, kStride);
+    }
+
+} // namespace vkcommon
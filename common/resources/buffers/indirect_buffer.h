@@ -0,0 +1,60 @@
+#ifndef INDIRECT_BUFFER_H
+#define INDIRECT_BUFFER_H
+
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "resources/buffers/buffer.h"
+
+namespace vkcommon {
+
+    class Device;
+    class MemoryAllocator;
+    class UploadContext;
+
+    // Device-local array of VkDrawIndexedIndirectCommand
+    class IndirectBuffer {
+    public:
+        IndirectBuffer(const Device& device, MemoryAllocator& allocator);
+        ~IndirectBuffer() = default;
+
+        // Disable copying
+        IndirectBuffer(const IndirectBuffer&) = delete;
+        IndirectBuffer& operator=(const IndirectBuffer&) = delete;
+
+        // Enable moving
+        IndirectBuffer(IndirectBuffer&& other) noexcept = default;
+        IndirectBuffer& operator=(IndirectBuffer&& other) noexcept = default;
+
+        // extraUsage lets compute passes write the commands, e.g. for culling
+        void create(const std::vector<VkDrawIndexedIndirectCommand>& commands,
+            UploadContext& uploadContext,
+            VkBufferUsageFlags extraUsage = 0);
+
+        // Draws commands [firstCommand, firstCommand + count); issues one
+        // vkCmdDrawIndexedIndirect per command without multiDrawIndirect
+        void draw(VkCommandBuffer commandBuffer, uint32_t firstCommand, uint32_t count) const;
+
+        // Draws up to maxCount commands from firstCommand, the actual count is
+        // a uint32_t read from countBuffer on the GPU; requires drawIndirectCount
+        void drawCount(VkCommandBuffer commandBuffer,
+            VkBuffer countBuffer,
+            VkDeviceSize countOffset,
+            uint32_t firstCommand,
+            uint32_t maxCount) const;
+
+        VkBuffer handle() const { return m_buffer.handle(); }
+        uint32_t commandCount() const { return m_commandCount; }
+
+        static constexpr uint32_t kStride = sizeof(VkDrawIndexedIndirectCommand);
+
+    private:
+        const Device& m_deviceRef;
+        Buffer m_buffer;
+        uint32_t m_commandCount{ 0 };
+    };
+
+} // namespace vkcommon
+
+#endif // INDIRECT_BUFFER_H
@@ -0,0 +1,86 @@
+#include "staging_ring.h"
+
+namespace vkcommon {
+
+    StagingRing::StagingRing(const Device& device, MemoryAllocator& allocator)
+        : m_buffer(device, allocator) {
+    }
+
+    void StagingRing::create(VkDeviceSize size) {
+        m_size = size;
+        m_head = 0;
+        m_tail = 0;
+        m_used = 0;
+        m_openBytes = 0;
+        m_regions.clear();
+
+        m_buffer.create(
+            size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+    }
+
+    std::optional<VkDeviceSize> StagingRing::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+        if (size > m_size) {
+            return std::nullopt;
+        }
+
+        // Nothing in flight, start over from the beginning
+        if (m_used == 0) {
+            m_head = 0;
+            m_tail = 0;
+        }
+        else if (m_head == m_tail) {
+            return std::nullopt;
+        }
+
+        VkDeviceSize offset = (m_head + alignment - 1) / alignment * alignment;
+        VkDeviceSize consumed = 0;
+
+        if (m_head >= m_tail) {
+            // Free space is [head, size) followed by [0, tail)
+            if (offset + size <= m_size) {
+                consumed = offset + size - m_head;
+            }
+            else if (size <= m_tail) {
+                offset = 0;
+                consumed = (m_size - m_head) + size;
+            }
+            else {
+                return std::nullopt;
+            }
+        }
+        else {
+            // Free space is [head, tail)
+            if (offset + size > m_tail) {
+                return std::nullopt;
+            }
+            consumed = offset + size - m_head;
+        }
+
+        m_head = offset + size;
+        m_used += consumed;
+        m_openBytes += consumed;
+
+        return offset;
+    }
+
+    void StagingRing::close(uint64_t submission) {
+        if (m_openBytes == 0) {
+            return;
+        }
+
+        m_regions.push_back({ submission, m_head, m_openBytes });
+        m_openBytes = 0;
+    }
+
+    void StagingRing::release(uint64_t completed) {
+        while (!m_regions.empty() && m_regions.front().submission <= completed) {
+            m_tail = m_regions.front().end;
+            m_used -= m_regions.front().bytes;
+            m_regions.pop_front();
+        }
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,67 @@
+#ifndef STAGING_RING_H
+#define STAGING_RING_H
+
+#include "buffer.h"
+
+#include <deque>
+#include <optional>
+
+namespace vkcommon {
+
+    class Device;
+    class MemoryAllocator;
+
+    // Persistently mapped host-visible buffer that staging data is written into
+    // front to back, wrapping around at the end. Space is handed out in regions
+    // tagged with the id of the submission that reads them, and only reclaimed
+    // once that submission is known to have completed.
+    class StagingRing {
+    public:
+        StagingRing(const Device& device, MemoryAllocator& allocator);
+        ~StagingRing() = default;
+
+        // Disable copying
+        StagingRing(const StagingRing&) = delete;
+        StagingRing& operator=(const StagingRing&) = delete;
+
+        // Enable moving
+        StagingRing(StagingRing&& other) noexcept = default;
+        StagingRing& operator=(StagingRing&& other) noexcept = default;
+
+        void create(VkDeviceSize size);
+
+        // Contiguous range of size bytes, or nullopt if the ring has no room right now
+        std::optional<VkDeviceSize> allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+        // Tag everything allocated since the last close with a submission id
+        void close(uint64_t submission);
+
+        // Reclaim the regions of every submission up to and including completed
+        void release(uint64_t completed);
+
+        void* mapped(VkDeviceSize offset) const { return static_cast<char*>(m_buffer.mapped()) + offset; }
+        VkBuffer buffer() const { return m_buffer.handle(); }
+        VkDeviceSize size() const { return m_size; }
+        VkDeviceSize used() const { return m_used; }
+
+    private:
+        struct Region {
+            uint64_t submission;
+            VkDeviceSize end;
+            VkDeviceSize bytes;
+        };
+
+        Buffer m_buffer;
+
+        VkDeviceSize m_size{ 0 };
+        VkDeviceSize m_head{ 0 };  // Next byte to hand out
+        VkDeviceSize m_tail{ 0 };  // First byte still in use
+        VkDeviceSize m_used{ 0 };  // Bytes between tail and head, including wrap padding
+        VkDeviceSize m_openBytes{ 0 };
+
+        std::deque<Region> m_regions;
+    };
+
+} // namespace vkcommon
+
+#endif // STAGING_RING_H
@@ -28,6 +28,7 @@ namespace vkcommon {
         // Get buffer handle for descriptor binding
         VkBuffer buffer(uint32_t frame) const { return m_buffers[frame].handle(); }
         VkDeviceSize size() const { return m_bufferSize; }
+        void* mapped(uint32_t frame) const { return m_buffers[frame].mapped(); }
 
         //protected:
             // Helper method for derived classes to update data
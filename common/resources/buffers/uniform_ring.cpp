@@ -0,0 +1,54 @@
+#include "uniform_ring.h"
+
+#include "core/device.h"
+#include "core/physical_device.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace vkcommon {
+
+    UniformRing::UniformRing(const Device& device, MemoryAllocator& allocator)
+        : m_device(device)
+        , m_buffer(device, allocator) {
+        m_alignment = m_device.physicalDevice().properties().limits.minUniformBufferOffsetAlignment;
+        if (m_alignment == 0) {
+            m_alignment = 1;
+        }
+    }
+
+    VkDeviceSize UniformRing::alignedSize(VkDeviceSize size) const {
+        return (size + m_alignment - 1) / m_alignment * m_alignment;
+    }
+
+    void UniformRing::create(VkDeviceSize frameSize, uint32_t framesInFlight) {
+        m_frameSize = alignedSize(frameSize);
+        m_frameBegin = 0;
+        m_head = 0;
+
+        m_buffer.create(
+            m_frameSize * framesInFlight,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+    }
+
+    void UniformRing::beginFrame(uint32_t currentFrame) {
+        m_frameBegin = m_frameSize * currentFrame;
+        m_head = m_frameBegin;
+    }
+
+    uint32_t UniformRing::push(const void* data, VkDeviceSize size) {
+        VkDeviceSize sliceSize = alignedSize(size);
+        if (m_head + sliceSize > m_frameBegin + m_frameSize) {
+            throw std::runtime_error("Uniform ring frame region is full");
+        }
+
+        VkDeviceSize offset = m_head;
+        memcpy(static_cast<char*>(m_buffer.mapped()) + offset, data, size);
+        m_head += sliceSize;
+
+        return static_cast<uint32_t>(offset);
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,52 @@
+#ifndef UNIFORM_RING_H
+#define UNIFORM_RING_H
+
+#include "buffer.h"
+
+namespace vkcommon {
+
+    class Device;
+    class MemoryAllocator;
+
+    // One host-visible uniform buffer split into a region per frame in flight.
+    // Each frame, uniforms are pushed as minUniformBufferOffsetAlignment-aligned
+    // slices and bound through VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC offsets.
+    class UniformRing {
+    public:
+        UniformRing(const Device& device, MemoryAllocator& allocator);
+        ~UniformRing() = default;
+
+        // Disable copying
+        UniformRing(const UniformRing&) = delete;
+        UniformRing& operator=(const UniformRing&) = delete;
+
+        // Enable moving
+        UniformRing(UniformRing&& other) noexcept = default;
+        UniformRing& operator=(UniformRing&& other) noexcept = delete;
+
+        void create(VkDeviceSize frameSize, uint32_t framesInFlight);
+
+        // Rewind to the start of this frame's region; the GPU must be done with it
+        void beginFrame(uint32_t currentFrame);
+
+        // Copies data into the ring and returns the dynamic offset to bind it with
+        uint32_t push(const void* data, VkDeviceSize size);
+
+        VkDeviceSize alignedSize(VkDeviceSize size) const;
+
+        VkBuffer buffer() const { return m_buffer.handle(); }
+        VkDeviceSize frameSize() const { return m_frameSize; }
+
+    private:
+        const Device& m_device;
+        Buffer m_buffer;
+
+        VkDeviceSize m_alignment{ 1 };
+        VkDeviceSize m_frameSize{ 0 };
+        VkDeviceSize m_frameBegin{ 0 };
+        VkDeviceSize m_head{ 0 };
+    };
+
+} // namespace vkcommon
+
+#endif // UNIFORM_RING_H
@@ -1,7 +1,7 @@
 #include "vertex_buffer.h"
 
 #include "core/device.h"
-#include "graphics/command_pool.h"
+#include "graphics/upload_context.h"
 #include "resources/buffers/buffer.h"
 #include "resources/memory/memory_allocator.h"
 
@@ -70,19 +70,8 @@ namespace vkcommon {
     }
 
     void VertexBuffer::createVertexBuffer(const std::vector<Vertex>& vertices,
-        const CommandPool& cmdPool) {
+        UploadContext& uploadContext) {
         VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-        
-        Buffer stagingBuffer(m_device, m_allocator);
-        // Create staging buffer
-        stagingBuffer.create(
-            bufferSize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        );
-
-        // Copy vertex data to staging buffer
-        stagingBuffer.update(vertices.data(), bufferSize);
 
         // Create vertex buffer
         m_vertexBuffer.create(
@@ -91,25 +80,13 @@ namespace vkcommon {
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
         );
 
-        // Copy from staging to vertex buffer
-        m_vertexBuffer.copyFrom(stagingBuffer, bufferSize, cmdPool);
+        // Stage and copy to vertex buffer
+        uploadContext.uploadBuffer(m_vertexBuffer, vertices.data(), bufferSize);
     }
 
     void VertexBuffer::createIndexBuffer(const std::vector<uint32_t>& indices,
-        const CommandPool& cmdPool) {
+        UploadContext& uploadContext) {
         VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-        
-        Buffer stagingBuffer(m_device, m_allocator);
-
-        // Create staging buffer
-        stagingBuffer.create(
-            bufferSize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        );
-
-        // Copy index data to staging buffer
-        stagingBuffer.update(indices.data(), bufferSize);
 
         // Create index buffer
         m_indexBuffer.create(
@@ -118,8 +95,8 @@ namespace vkcommon {
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
         );
 
-        // Copy from staging to index buffer
-        m_indexBuffer.copyFrom(stagingBuffer, bufferSize, cmdPool);
+        // Stage and copy to index buffer
+        uploadContext.uploadBuffer(m_indexBuffer, indices.data(), bufferSize);
     }
 
     // TODO: not sure if this is the best way to bind buffers
@@ -14,7 +14,7 @@
 namespace vkcommon
 {
     class Device;
-    class CommandPool;
+    class UploadContext;
     class MemoryAllocator;
     class Buffer;
 
@@ -43,8 +43,9 @@ namespace vkcommon
         VertexBuffer(VertexBuffer&& other) noexcept;
         VertexBuffer& operator=(VertexBuffer&& other) noexcept;
 
-        void createVertexBuffer(const std::vector<Vertex>& vertices, const CommandPool& cmdPool);
-        void createIndexBuffer(const std::vector<uint32_t>& indices, const CommandPool& cmdPool);
+        // Copies are recorded into the upload context and run when it is flushed
+        void createVertexBuffer(const std::vector<Vertex>& vertices, UploadContext& uploadContext);
+        void createIndexBuffer(const std::vector<uint32_t>& indices, UploadContext& uploadContext);
 
         void bindVertexBuffer(VkCommandBuffer commandBuffer, uint32_t firstBinding);
         void bindIndexBuffer(VkCommandBuffer commandBuffer, VkIndexType indexType);
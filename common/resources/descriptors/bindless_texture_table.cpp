@@ -0,0 +1,63 @@
+#include "bindless_texture_table.h"
+
+#include "core/device.h"
+#include "resources/images/texture.h"
+#include "resources/descriptors/descriptor_set_layout_cache.h"
+#include "resources/descriptors/descriptor_writer.h"
+
+#include <stdexcept>
+
+namespace vkcommon {
+
+    BindlessTextureTable::BindlessTextureTable(const Device& device, uint32_t capacity)
+        : m_device(device)
+        , m_capacity(capacity)
+        , m_pool(device) {
+        if (!device.supportsBindlessTextures()) {
+            throw std::runtime_error("Failed to create bindless texture table: descriptor indexing is not supported");
+        }
+
+        // Any stage may sample; the limits for update-after-bind samplers are
+        // at least 500000 wherever descriptor indexing is supported
+        m_layout = &device.descriptorSetLayoutCache().get(
+            { DescriptorSetLayoutCache::binding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL, m_capacity) },
+            { VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+              VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+              VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT });
+
+        m_pool.addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_capacity);
+        m_pool.create(1, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT);
+        m_descriptorSet = m_pool.allocate(m_layout->handle());
+    }
+
+    uint32_t BindlessTextureTable::add(const Texture& texture) {
+        auto it = m_indices.find(&texture);
+        if (it != m_indices.end()) {
+            return it->second;
+        }
+
+        if (size() >= m_capacity) {
+            throw std::runtime_error("Failed to add texture: bindless texture table is full");
+        }
+
+        uint32_t index = size();
+        DescriptorWriter writer{ m_descriptorSet };
+        writer.writeImage(
+            0,
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            texture.imageView(),
+            texture.sampler(),
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            index);
+        writer.update(m_device);
+
+        m_indices.emplace(&texture, index);
+        return index;
+    }
+
+    uint32_t BindlessTextureTable::indexOf(const Texture& texture) const {
+        auto it = m_indices.find(&texture);
+        return it != m_indices.end() ? it->second : kNoTexture;
+    }
+
+} // namespace vkcommon
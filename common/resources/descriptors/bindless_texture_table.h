@@ -0,0 +1,58 @@
+#ifndef BINDLESS_TEXTURE_TABLE_H
+#define BINDLESS_TEXTURE_TABLE_H
+
+#include <vulkan/vulkan.h>
+
+#include <unordered_map>
+
+#include "resources/descriptors/descriptor_set_layout.h"
+#include "resources/descriptors/descriptor_pool.h"
+
+namespace vkcommon {
+
+    class Device;
+    class Texture;
+
+    // Every registered texture in one runtime-sized array of combined image
+    // samplers (binding 0 of a single set). Shaders pick textures by index,
+    // so the set is bound once however many materials are drawn.
+    // Slots are written update-after-bind and left unused ones unwritten,
+    // so textures can be added while earlier frames still use the set.
+    // Needs Device::supportsBindlessTextures().
+    class BindlessTextureTable {
+    public:
+        // Index of a missing texture, shaders test for it
+        static constexpr uint32_t kNoTexture = 0xFFFFFFFFu;
+
+        explicit BindlessTextureTable(const Device& device, uint32_t capacity = 4096);
+        ~BindlessTextureTable() = default;
+
+        // Disable copying
+        BindlessTextureTable(const BindlessTextureTable&) = delete;
+        BindlessTextureTable& operator=(const BindlessTextureTable&) = delete;
+
+        // Writes the texture into the next free slot, or returns the slot it
+        // already has. Throws when the table is full.
+        uint32_t add(const Texture& texture);
+        // kNoTexture if the texture was never added
+        uint32_t indexOf(const Texture& texture) const;
+
+        const DescriptorSetLayout& layout() const { return *m_layout; }
+        VkDescriptorSet descriptorSet() const { return m_descriptorSet; }
+
+        uint32_t size() const { return static_cast<uint32_t>(m_indices.size()); }
+        uint32_t capacity() const { return m_capacity; }
+
+    private:
+        const Device& m_device;
+        uint32_t m_capacity;
+        // Owned by the device's layout cache
+        const DescriptorSetLayout* m_layout{ nullptr };
+        DescriptorPool m_pool;
+        VkDescriptorSet m_descriptorSet{ VK_NULL_HANDLE };
+        std::unordered_map<const Texture*, uint32_t> m_indices;
+    };
+
+} // namespace vkcommon
+
+#endif // BINDLESS_TEXTURE_TABLE_H
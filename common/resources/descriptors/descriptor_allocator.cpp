@@ -0,0 +1,93 @@
+#include "descriptor_allocator.h"
+
+#include "core/device.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace vkcommon {
+
+    DescriptorAllocator::DescriptorAllocator(const Device& device,
+        std::vector<PoolRatio> ratios,
+        uint32_t initialSetsPerPool)
+        : m_device(device)
+        , m_ratios(std::move(ratios))
+        , m_setsPerPool(std::max(initialSetsPerPool, 1u)) {
+    }
+
+    std::vector<DescriptorAllocator::PoolRatio> DescriptorAllocator::defaultRatios() {
+        return {
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 0.5f },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f },
+            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f },
+        };
+    }
+
+    VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+        for (;;) {
+            bool freshPool = m_currentPool == m_pools.size();
+            if (freshPool) {
+                m_pools.push_back(createPool());
+            }
+
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+            VkResult result = m_pools[m_currentPool].tryAllocate(layout, descriptorSet);
+            if (result == VK_SUCCESS) {
+                return descriptorSet;
+            }
+
+            if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+                throw std::runtime_error("Failed to allocate descriptor set");
+            }
+            if (freshPool) {
+                throw std::runtime_error("Failed to allocate descriptor set: layout does not fit in an empty pool");
+            }
+
+            // Full, try the next pool or grow the chain
+            m_currentPool++;
+        }
+    }
+
+    void DescriptorAllocator::reset() {
+        for (auto& pool : m_pools) {
+            pool.reset();
+        }
+        m_currentPool = 0;
+    }
+
+    DescriptorPool DescriptorAllocator::createPool() {
+        DescriptorPool pool(m_device);
+        for (const auto& ratio : m_ratios) {
+            uint32_t count = static_cast<uint32_t>(ratio.ratio * static_cast<float>(m_setsPerPool));
+            pool.addPoolSize(ratio.type, std::max(count, 1u));
+        }
+        // Never freed one by one, only reset
+        pool.create(m_setsPerPool, 0);
+
+        // Each new pool is larger, so the chain stays short
+        m_setsPerPool = std::min(m_setsPerPool * 2, kMaxSetsPerPool);
+        return pool;
+    }
+
+    FrameDescriptorAllocator::FrameDescriptorAllocator(const Device& device, uint32_t framesInFlight,
+        std::vector<DescriptorAllocator::PoolRatio> ratios) {
+        m_frames.reserve(framesInFlight);
+        for (uint32_t i = 0; i < framesInFlight; ++i) {
+            m_frames.emplace_back(device, ratios);
+        }
+    }
+
+    void FrameDescriptorAllocator::beginFrame(uint32_t frameIndex) {
+        m_currentFrame = frameIndex;
+        m_frames[m_currentFrame].reset();
+    }
+
+    VkDescriptorSet FrameDescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+        return m_frames[m_currentFrame].allocate(layout);
+    }
+
+} // namespace vkcommon
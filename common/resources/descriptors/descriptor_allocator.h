@@ -0,0 +1,80 @@
+#ifndef DESCRIPTOR_ALLOCATOR_H
+#define DESCRIPTOR_ALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+#include "resources/descriptors/descriptor_pool.h"
+
+namespace vkcommon {
+
+    class Device;
+
+    // Hands out descriptor sets from a chain of pools, adding a larger pool
+    // whenever the current one runs out, so callers never size pools up front.
+    // Sets are never freed one by one; reset() returns all of them at once.
+    class DescriptorAllocator {
+    public:
+        // Descriptors of a type per set; every pool holds ratio * maxSets of them
+        struct PoolRatio {
+            VkDescriptorType type;
+            float ratio;
+        };
+
+        explicit DescriptorAllocator(const Device& device,
+            std::vector<PoolRatio> ratios = defaultRatios(),
+            uint32_t initialSetsPerPool = 64);
+        ~DescriptorAllocator() = default;
+
+        // Disable copying
+        DescriptorAllocator(const DescriptorAllocator&) = delete;
+        DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+        // Enable moving
+        DescriptorAllocator(DescriptorAllocator&& other) noexcept = default;
+        DescriptorAllocator& operator=(DescriptorAllocator&& other) noexcept = delete;
+
+        // Throws only if the layout does not fit in an empty pool
+        VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+        // Resets every pool with vkResetDescriptorPool and keeps them for reuse;
+        // all sets allocated so far become invalid
+        void reset();
+
+        size_t poolCount() const { return m_pools.size(); }
+
+        static std::vector<PoolRatio> defaultRatios();
+
+    private:
+        DescriptorPool createPool();
+
+        const Device& m_device;
+        std::vector<PoolRatio> m_ratios;
+        // Pools before m_currentPool are full until the next reset
+        std::vector<DescriptorPool> m_pools;
+        size_t m_currentPool{ 0 };
+        uint32_t m_setsPerPool;
+
+        static constexpr uint32_t kMaxSetsPerPool = 4096;
+    };
+
+    // One DescriptorAllocator per frame in flight for sets that live a single
+    // frame. beginFrame() resets that frame's pools wholesale, so it must be
+    // called once the frame's fence has signaled.
+    class FrameDescriptorAllocator {
+    public:
+        FrameDescriptorAllocator(const Device& device, uint32_t framesInFlight,
+            std::vector<DescriptorAllocator::PoolRatio> ratios = DescriptorAllocator::defaultRatios());
+
+        void beginFrame(uint32_t frameIndex);
+        VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+    private:
+        std::vector<DescriptorAllocator> m_frames;
+        uint32_t m_currentFrame{ 0 };
+    };
+
+} // namespace vkcommon
+
+#endif // DESCRIPTOR_ALLOCATOR_H
@@ -0,0 +1,39 @@
+#ifndef DESCRIPTOR_KEY_H
+#define DESCRIPTOR_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace vkcommon {
+
+    // Flattened binding list or set contents, equal keys describe identical objects
+    using DescriptorKey = std::vector<uint64_t>;
+
+    struct DescriptorKeyHash {
+        size_t operator()(const DescriptorKey& key) const noexcept {
+            // FNV-1a over the words
+            uint64_t hash = 14695981039346656037ull;
+            for (uint64_t word : key) {
+                hash ^= word;
+                hash *= 1099511628211ull;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    // Non-dispatchable handles are pointers on 64-bit and uint64_t on 32-bit
+    template <typename Handle>
+    uint64_t descriptorHandleBits(Handle handle) {
+        if constexpr (std::is_pointer_v<Handle>) {
+            return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+        }
+        else {
+            return static_cast<uint64_t>(handle);
+        }
+    }
+
+} // namespace vkcommon
+
+#endif // DESCRIPTOR_KEY_H
@@ -37,13 +37,13 @@ namespace vkcommon {
         m_poolSizes.push_back(poolSize);
     }
 
-    void DescriptorPool::create(uint32_t maxSets) {
+    void DescriptorPool::create(uint32_t maxSets, VkDescriptorPoolCreateFlags flags) {
         VkDescriptorPoolCreateInfo poolInfo{};
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.poolSizeCount = static_cast<uint32_t>(m_poolSizes.size());
         poolInfo.pPoolSizes = m_poolSizes.data();
         poolInfo.maxSets = maxSets;
-        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;  // Optional: allows freeing individual sets
+        poolInfo.flags = flags;
 
         if (vkCreateDescriptorPool(m_device.handle(), &poolInfo, nullptr, &m_pool) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create descriptor pool");
@@ -65,6 +65,20 @@ namespace vkcommon {
         return descriptorSet;
     }
 
+    VkResult DescriptorPool::tryAllocate(VkDescriptorSetLayout layout, VkDescriptorSet& descriptorSet) {
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_pool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+
+        return vkAllocateDescriptorSets(m_device.handle(), &allocInfo, &descriptorSet);
+    }
+
+    void DescriptorPool::reset() {
+        vkResetDescriptorPool(m_device.handle(), m_pool, 0);
+    }
+
     std::vector<VkDescriptorSet> DescriptorPool::allocate(VkDescriptorSetLayout layout, uint32_t count) {
         std::vector<VkDescriptorSetLayout> layouts(count, layout);
 
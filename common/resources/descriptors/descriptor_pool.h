@@ -22,10 +22,17 @@ namespace vkcommon {
         DescriptorPool& operator=(DescriptorPool&& other) noexcept;
 
         void addPoolSize(VkDescriptorType type, uint32_t count);
-        void create(uint32_t maxSets);
+        // Pools that are only ever reset can drop FREE_DESCRIPTOR_SET_BIT
+        void create(uint32_t maxSets,
+            VkDescriptorPoolCreateFlags flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
 
         VkDescriptorSet allocate(VkDescriptorSetLayout layout);
         std::vector<VkDescriptorSet> allocate(VkDescriptorSetLayout layout, uint32_t count);
+        // Reports exhaustion (VK_ERROR_OUT_OF_POOL_MEMORY, VK_ERROR_FRAGMENTED_POOL)
+        // instead of throwing, so callers can move on to another pool
+        VkResult tryAllocate(VkDescriptorSetLayout layout, VkDescriptorSet& descriptorSet);
+        // Returns every set to the pool at once
+        void reset();
 
         VkDescriptorPool handle() const { return m_pool; }
 
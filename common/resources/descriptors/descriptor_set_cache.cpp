@@ -0,0 +1,57 @@
+#include "descriptor_set_cache.h"
+
+#include "core/device.h"
+#include "resources/descriptors/descriptor_allocator.h"
+#include "resources/descriptors/descriptor_set_layout.h"
+#include "resources/descriptors/descriptor_writer.h"
+
+#include <algorithm>
+
+namespace vkcommon {
+
+    DescriptorSetCache::DescriptorSetCache(const Device& device, DescriptorAllocator& allocator)
+        : m_device(device)
+        , m_allocator(allocator) {
+    }
+
+    VkDescriptorSet DescriptorSetCache::get(const DescriptorSetLayout& layout, DescriptorWriter& writer) {
+        // Layouts come from DescriptorSetLayoutCache, so equal layouts share a handle
+        DescriptorKey key = writer.key();
+        key.push_back(descriptorHandleBits(layout.handle()));
+
+        auto it = m_sets.find(key);
+        if (it != m_sets.end()) {
+            m_hits++;
+            return it->second.set;
+        }
+
+        VkDescriptorSet descriptorSet = m_allocator.allocate(layout.handle());
+        writer.update(m_device, layout, descriptorSet);
+
+        m_misses++;
+        m_sets.emplace(std::move(key), CachedSet{ descriptorSet, writer.resourceHandles() });
+        return descriptorSet;
+    }
+
+    size_t DescriptorSetCache::forgetHandle(uint64_t handleBits) {
+        size_t forgotten = 0;
+        for (auto it = m_sets.begin(); it != m_sets.end();) {
+            const std::vector<uint64_t>& handles = it->second.handles;
+            if (std::find(handles.begin(), handles.end(), handleBits) != handles.end()) {
+                it = m_sets.erase(it);
+                forgotten++;
+            }
+            else {
+                ++it;
+            }
+        }
+        return forgotten;
+    }
+
+    void DescriptorSetCache::clear() {
+        m_sets.clear();
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,68 @@
+#ifndef DESCRIPTOR_SET_CACHE_H
+#define DESCRIPTOR_SET_CACHE_H
+
+#include <vulkan/vulkan.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "resources/descriptors/descriptor_key.h"
+
+namespace vkcommon {
+
+    class Device;
+    class DescriptorAllocator;
+    class DescriptorSetLayout;
+    class DescriptorWriter;
+
+    // Descriptor sets keyed on their layout and the resources written into
+    // them. Users binding the same textures or the same buffer range get the
+    // same set, allocated and written only the first time it is asked for.
+    // Sets are never rewritten, so resources must stay alive while the sets
+    // naming them are in use. Keys hold raw handle bits, so a resource that
+    // is destroyed must be forgotten before a new one can reuse its handle;
+    // clear() together with the allocator's reset() drops everything.
+    class DescriptorSetCache {
+    public:
+        DescriptorSetCache(const Device& device, DescriptorAllocator& allocator);
+
+        // Disable copying
+        DescriptorSetCache(const DescriptorSetCache&) = delete;
+        DescriptorSetCache& operator=(const DescriptorSetCache&) = delete;
+
+        // writer holds the contents; its own target set is ignored
+        VkDescriptorSet get(const DescriptorSetLayout& layout, DescriptorWriter& writer);
+
+        // Forgets every set naming the buffer, image view or sampler, so a
+        // later resource with the same handle gets a new set. The sets are
+        // not freed, they go back with the allocator's reset().
+        template <typename Handle>
+        size_t forget(Handle handle) { return forgetHandle(descriptorHandleBits(handle)); }
+
+        // Forgets every set, does not free them
+        void clear();
+
+        size_t size() const { return m_sets.size(); }
+        // Requests served by an existing set, without vkUpdateDescriptorSets
+        size_t hits() const { return m_hits; }
+        size_t misses() const { return m_misses; }
+
+    private:
+        struct CachedSet {
+            VkDescriptorSet set;
+            // Resources written into the set, for forget()
+            std::vector<uint64_t> handles;
+        };
+
+        size_t forgetHandle(uint64_t handleBits);
+
+        const Device& m_device;
+        DescriptorAllocator& m_allocator;
+        std::unordered_map<DescriptorKey, CachedSet, DescriptorKeyHash> m_sets;
+        size_t m_hits{ 0 };
+        size_t m_misses{ 0 };
+    };
+
+} // namespace vkcommon
+
+#endif // DESCRIPTOR_SET_CACHE_H
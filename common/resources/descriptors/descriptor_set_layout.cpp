@@ -1,5 +1,6 @@
 #include "descriptor_set_layout.h"
 #include "core/device.h"
+#include <algorithm>
 #include <stdexcept>
 
 namespace vkcommon {
@@ -15,7 +16,10 @@ namespace vkcommon {
     DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout&& other) noexcept
         : m_device(other.m_device)
         , m_layout(other.m_layout)
-        , m_bindings(std::move(other.m_bindings)) {
+        , m_bindings(std::move(other.m_bindings))
+        , m_bindingFlags(std::move(other.m_bindingFlags))
+        , m_updateTemplates(std::move(other.m_updateTemplates)) {
+        other.m_updateTemplates.clear();
         other.m_layout = VK_NULL_HANDLE;
     }
 
@@ -24,6 +28,9 @@ namespace vkcommon {
             cleanup();
             m_layout = other.m_layout;
             m_bindings = std::move(other.m_bindings);
+            m_bindingFlags = std::move(other.m_bindingFlags);
+            m_updateTemplates = std::move(other.m_updateTemplates);
+            other.m_updateTemplates.clear();
             other.m_layout = VK_NULL_HANDLE;
         }
         return *this;
@@ -32,7 +39,8 @@ namespace vkcommon {
     void DescriptorSetLayout::addBinding(uint32_t binding,
         VkDescriptorType type,
         VkShaderStageFlags stageFlags,
-        uint32_t count) {
+        uint32_t count,
+        VkDescriptorBindingFlags bindingFlags) {
         VkDescriptorSetLayoutBinding layoutBinding{};
         layoutBinding.binding = binding;
         layoutBinding.descriptorType = type;
@@ -41,6 +49,7 @@ namespace vkcommon {
         layoutBinding.pImmutableSamplers = nullptr;
 
         m_bindings.push_back(layoutBinding);
+        m_bindingFlags.push_back(bindingFlags);
     }
 
     void DescriptorSetLayout::create() {
@@ -49,12 +58,78 @@ namespace vkcommon {
         layoutInfo.bindingCount = static_cast<uint32_t>(m_bindings.size());
         layoutInfo.pBindings = m_bindings.data();
 
+        // Only chained when used, so plain layouts need no descriptor indexing
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount = static_cast<uint32_t>(m_bindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = m_bindingFlags.data();
+
+        VkDescriptorBindingFlags allFlags = 0;
+        for (VkDescriptorBindingFlags flags : m_bindingFlags) {
+            allFlags |= flags;
+        }
+        if (allFlags != 0) {
+            layoutInfo.pNext = &bindingFlagsInfo;
+        }
+        if (allFlags & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT) {
+            layoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        }
+
         if (vkCreateDescriptorSetLayout(m_device.handle(), &layoutInfo, nullptr, &m_layout) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create descriptor set layout");
         }
     }
 
+    VkDescriptorUpdateTemplate DescriptorSetLayout::updateTemplate(uint64_t bindingMask) const {
+        auto it = m_updateTemplates.find(bindingMask);
+        if (it != m_updateTemplates.end()) {
+            return it->second;
+        }
+
+        std::vector<VkDescriptorUpdateTemplateEntry> entries;
+        for (uint32_t binding = 0; binding < 64; binding++) {
+            if ((bindingMask & (uint64_t{ 1 } << binding)) == 0) {
+                continue;
+            }
+
+            auto layoutBinding = std::find_if(m_bindings.begin(), m_bindings.end(),
+                [binding](const VkDescriptorSetLayoutBinding& b) { return b.binding == binding; });
+            if (layoutBinding == m_bindings.end()) {
+                throw std::runtime_error("Failed to create descriptor update template: binding not in layout");
+            }
+
+            VkDescriptorUpdateTemplateEntry entry{};
+            entry.dstBinding = binding;
+            entry.dstArrayElement = 0;
+            entry.descriptorCount = 1;
+            entry.descriptorType = layoutBinding->descriptorType;
+            entry.offset = entries.size() * sizeof(DescriptorTemplateEntry);
+            entry.stride = sizeof(DescriptorTemplateEntry);
+            entries.push_back(entry);
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo templateInfo{};
+        templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        templateInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+        templateInfo.pDescriptorUpdateEntries = entries.data();
+        templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        templateInfo.descriptorSetLayout = m_layout;
+
+        VkDescriptorUpdateTemplate updateTemplate = VK_NULL_HANDLE;
+        if (vkCreateDescriptorUpdateTemplate(m_device.handle(), &templateInfo, nullptr, &updateTemplate) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create descriptor update template");
+        }
+
+        m_updateTemplates.emplace(bindingMask, updateTemplate);
+        return updateTemplate;
+    }
+
     void DescriptorSetLayout::cleanup() {
+        for (const auto& [mask, updateTemplate] : m_updateTemplates) {
+            vkDestroyDescriptorUpdateTemplate(m_device.handle(), updateTemplate, nullptr);
+        }
+        m_updateTemplates.clear();
+
         if (m_layout != VK_NULL_HANDLE) {
             vkDestroyDescriptorSetLayout(m_device.handle(), m_layout, nullptr);
             m_layout = VK_NULL_HANDLE;
@@ -2,12 +2,21 @@
 #define DESCRIPTOR_SET_LAYOUT_H
 
 #include <vulkan/vulkan.h>
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 namespace vkcommon {
 
     class Device;
 
+    // One descriptor of the packed data an update template reads
+    union DescriptorTemplateEntry {
+        VkDescriptorImageInfo image;
+        VkDescriptorBufferInfo buffer;
+        VkBufferView texelBuffer;
+    };
+
     class DescriptorSetLayout {
     public:
         explicit DescriptorSetLayout(const Device& device);
@@ -21,18 +30,31 @@ namespace vkcommon {
         DescriptorSetLayout(DescriptorSetLayout&& other) noexcept;
         DescriptorSetLayout& operator=(DescriptorSetLayout&& other) noexcept;
 
+        // Bindings with UPDATE_AFTER_BIND_BIT make the whole layout
+        // update-after-bind; its sets need a pool created with the matching flag
         void addBinding(uint32_t binding,
             VkDescriptorType type,
             VkShaderStageFlags stageFlags,
-            uint32_t count = 1);
+            uint32_t count = 1,
+            VkDescriptorBindingFlags bindingFlags = 0);
         void create();
 
         VkDescriptorSetLayout handle() const { return m_layout; }
 
+        // Template writing element 0 of every binding in bindingMask (bit n
+        // for binding n, bindings below 64 only) from DescriptorTemplateEntry
+        // values packed in binding order. Built on first use per mask and
+        // kept with the layout; not thread safe.
+        VkDescriptorUpdateTemplate updateTemplate(uint64_t bindingMask) const;
+
     private:
         const Device& m_device;
         VkDescriptorSetLayout m_layout{ VK_NULL_HANDLE };
         std::vector<VkDescriptorSetLayoutBinding> m_bindings;
+        // Parallel to m_bindings
+        std::vector<VkDescriptorBindingFlags> m_bindingFlags;
+        // Most layouts only ever see one mask
+        mutable std::unordered_map<uint64_t, VkDescriptorUpdateTemplate> m_updateTemplates;
 
         void cleanup();
     };
@@ -0,0 +1,81 @@
+#include "descriptor_set_layout_cache.h"
+
+#include "core/device.h"
+#include "resources/descriptors/descriptor_set_layout.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace vkcommon {
+
+    DescriptorSetLayoutCache::DescriptorSetLayoutCache(const Device& device)
+        : m_device(device) {
+    }
+
+    DescriptorSetLayoutCache::~DescriptorSetLayoutCache() = default;
+
+    const DescriptorSetLayout& DescriptorSetLayoutCache::get(std::vector<VkDescriptorSetLayoutBinding> bindings) {
+        std::vector<VkDescriptorBindingFlags> bindingFlags(bindings.size(), 0);
+        return get(std::move(bindings), std::move(bindingFlags));
+    }
+
+    const DescriptorSetLayout& DescriptorSetLayoutCache::get(
+        std::vector<VkDescriptorSetLayoutBinding> bindings,
+        std::vector<VkDescriptorBindingFlags> bindingFlags) {
+        if (bindingFlags.size() != bindings.size()) {
+            throw std::runtime_error("Failed to cache descriptor set layout: binding flags do not match the bindings");
+        }
+
+        // Sorted together, so each binding keeps its flags
+        std::vector<size_t> order(bindings.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&bindings](size_t a, size_t b) {
+            return bindings[a].binding < bindings[b].binding;
+        });
+
+        DescriptorKey key;
+        key.reserve(bindings.size() * 3);
+        for (size_t index : order) {
+            const VkDescriptorSetLayoutBinding& binding = bindings[index];
+            if (binding.pImmutableSamplers != nullptr) {
+                throw std::runtime_error("Failed to cache descriptor set layout: immutable samplers are not supported");
+            }
+            key.push_back((static_cast<uint64_t>(binding.binding) << 32) | binding.descriptorCount);
+            key.push_back((static_cast<uint64_t>(binding.descriptorType) << 32) | binding.stageFlags);
+            key.push_back(bindingFlags[index]);
+        }
+
+        auto it = m_layouts.find(key);
+        if (it != m_layouts.end()) {
+            return *it->second;
+        }
+
+        auto layout = std::make_unique<DescriptorSetLayout>(m_device);
+        for (size_t index : order) {
+            const VkDescriptorSetLayoutBinding& binding = bindings[index];
+            layout->addBinding(binding.binding, binding.descriptorType, binding.stageFlags, binding.descriptorCount,
+                bindingFlags[index]);
+        }
+        layout->create();
+
+        return *m_layouts.emplace(std::move(key), std::move(layout)).first->second;
+    }
+
+    void DescriptorSetLayoutCache::clear() {
+        m_layouts.clear();
+    }
+
+    VkDescriptorSetLayoutBinding DescriptorSetLayoutCache::binding(uint32_t binding,
+        VkDescriptorType type,
+        VkShaderStageFlags stageFlags,
+        uint32_t count) {
+        VkDescriptorSetLayoutBinding layoutBinding{};
+        layoutBinding.binding = binding;
+        layoutBinding.descriptorType = type;
+        layoutBinding.descriptorCount = count;
+        layoutBinding.stageFlags = stageFlags;
+        return layoutBinding;
+    }
+
+} // namespace vkcommon
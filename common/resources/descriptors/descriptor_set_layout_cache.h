@@ -0,0 +1,55 @@
+#ifndef DESCRIPTOR_SET_LAYOUT_CACHE_H
+#define DESCRIPTOR_SET_LAYOUT_CACHE_H
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "resources/descriptors/descriptor_key.h"
+
+namespace vkcommon {
+
+    class Device;
+    class DescriptorSetLayout;
+
+    // Device-wide set of descriptor set layouts keyed on their binding lists.
+    // Every caller asking for the same bindings gets the same layout, so
+    // layouts are equal by handle and sets written for one fit all of them.
+    class DescriptorSetLayoutCache {
+    public:
+        explicit DescriptorSetLayoutCache(const Device& device);
+        ~DescriptorSetLayoutCache();
+
+        // Disable copying
+        DescriptorSetLayoutCache(const DescriptorSetLayoutCache&) = delete;
+        DescriptorSetLayoutCache& operator=(const DescriptorSetLayoutCache&) = delete;
+
+        // Bindings may come in any order, immutable samplers are not supported.
+        // The layout lives until the cache is cleared.
+        const DescriptorSetLayout& get(std::vector<VkDescriptorSetLayoutBinding> bindings);
+        // bindingFlags is parallel to bindings, as in
+        // VkDescriptorSetLayoutBindingFlagsCreateInfo; flags are part of the key
+        const DescriptorSetLayout& get(
+            std::vector<VkDescriptorSetLayoutBinding> bindings,
+            std::vector<VkDescriptorBindingFlags> bindingFlags);
+
+        // Destroys every layout; sets and pipeline layouts using them must be gone
+        void clear();
+
+        size_t size() const { return m_layouts.size(); }
+
+        static VkDescriptorSetLayoutBinding binding(uint32_t binding,
+            VkDescriptorType type,
+            VkShaderStageFlags stageFlags,
+            uint32_t count = 1);
+
+    private:
+        const Device& m_device;
+        std::unordered_map<DescriptorKey, std::unique_ptr<DescriptorSetLayout>, DescriptorKeyHash> m_layouts;
+    };
+
+} // namespace vkcommon
+
+#endif // DESCRIPTOR_SET_LAYOUT_CACHE_H
@@ -1,8 +1,26 @@
 #include "descriptor_writer.h"
 
 #include "core/device.h"
+#include "resources/descriptors/descriptor_set_layout.h"
+
+#include <bit>
 
 namespace vkcommon {
+
+    namespace {
+        bool isBufferDescriptor(VkDescriptorType type) {
+            return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+                type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+                type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        }
+
+        bool isImageDescriptor(VkDescriptorType type) {
+            return type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+                type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        }
+    }
+
     DescriptorWriter::DescriptorWriter(VkDescriptorSet descriptorSet)
         : m_descriptorSet(descriptorSet) {
     }
@@ -38,7 +56,8 @@ namespace vkcommon {
         VkDescriptorType type,
         VkImageView imageView,
         VkSampler sampler,
-        VkImageLayout imageLayout) {
+        VkImageLayout imageLayout,
+        uint32_t arrayElement) {
 
         VkDescriptorImageInfo imageInfo{};
         imageInfo.imageLayout = imageLayout;
@@ -50,7 +69,7 @@ namespace vkcommon {
         write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         write.dstSet = m_descriptorSet;
         write.dstBinding = binding;
-        write.dstArrayElement = 0;
+        write.dstArrayElement = arrayElement;
         write.descriptorType = type;
         write.descriptorCount = 1;
         write.pImageInfo = nullptr; // Will be set later in update() function
@@ -59,17 +78,104 @@ namespace vkcommon {
         return *this;
     }
 
+    void DescriptorWriter::update(const Device& device, VkDescriptorSet descriptorSet) {
+        m_descriptorSet = descriptorSet;
+        for (auto& write : m_writes) {
+            write.dstSet = descriptorSet;
+        }
+        update(device);
+    }
+
+    void DescriptorWriter::update(const Device& device, const DescriptorSetLayout& layout) {
+        // Templates cover element 0 of each binding once; anything else goes the slow way
+        uint64_t bindingMask = 0;
+        for (const auto& write : m_writes) {
+            uint64_t bit = write.dstBinding < 64 ? uint64_t{ 1 } << write.dstBinding : 0;
+            bool packable = bit != 0 && (bindingMask & bit) == 0 && write.dstArrayElement == 0 &&
+                (isBufferDescriptor(write.descriptorType) || isImageDescriptor(write.descriptorType));
+            if (!packable) {
+                update(device);
+                return;
+            }
+            bindingMask |= bit;
+        }
+
+        if (bindingMask == 0) {
+            return;
+        }
+
+        // Packed in binding order, the order of the template's entries
+        std::vector<DescriptorTemplateEntry> data(m_writes.size());
+        size_t bufferIndex = 0;
+        size_t imageIndex = 0;
+        for (const auto& write : m_writes) {
+            uint64_t lowerBindings = bindingMask & ((uint64_t{ 1 } << write.dstBinding) - 1);
+            DescriptorTemplateEntry& entry = data[std::popcount(lowerBindings)];
+            if (isBufferDescriptor(write.descriptorType)) {
+                entry.buffer = m_bufferInfos[bufferIndex++];
+            }
+            else {
+                entry.image = m_imageInfos[imageIndex++];
+            }
+        }
+
+        vkUpdateDescriptorSetWithTemplate(device.handle(), m_descriptorSet, layout.updateTemplate(bindingMask), data.data());
+    }
+
+    void DescriptorWriter::update(const Device& device, const DescriptorSetLayout& layout, VkDescriptorSet descriptorSet) {
+        m_descriptorSet = descriptorSet;
+        for (auto& write : m_writes) {
+            write.dstSet = descriptorSet;
+        }
+        update(device, layout);
+    }
+
+    DescriptorKey DescriptorWriter::key() const {
+        // Same pairing of writes and infos as update()
+        DescriptorKey key;
+        size_t bufferIndex = 0;
+        size_t imageIndex = 0;
+        for (const auto& write : m_writes) {
+            key.push_back((static_cast<uint64_t>(write.dstBinding) << 32) | static_cast<uint64_t>(write.descriptorType));
+            key.push_back(write.dstArrayElement);
+            if (isBufferDescriptor(write.descriptorType)) {
+                const auto& info = m_bufferInfos[bufferIndex++];
+                key.push_back(descriptorHandleBits(info.buffer));
+                key.push_back(info.offset);
+                key.push_back(info.range);
+            }
+            else if (isImageDescriptor(write.descriptorType)) {
+                const auto& info = m_imageInfos[imageIndex++];
+                key.push_back(descriptorHandleBits(info.imageView));
+                key.push_back(descriptorHandleBits(info.sampler));
+                key.push_back(static_cast<uint64_t>(info.imageLayout));
+            }
+        }
+        return key;
+    }
+
+    std::vector<uint64_t> DescriptorWriter::resourceHandles() const {
+        std::vector<uint64_t> handles;
+        handles.reserve(m_bufferInfos.size() + 2 * m_imageInfos.size());
+        for (const auto& info : m_bufferInfos) {
+            handles.push_back(descriptorHandleBits(info.buffer));
+        }
+        for (const auto& info : m_imageInfos) {
+            handles.push_back(descriptorHandleBits(info.imageView));
+            handles.push_back(descriptorHandleBits(info.sampler));
+        }
+        return handles;
+    }
+
     void DescriptorWriter::update(const Device& device) {
         // Update buffer and image info pointers
         size_t bufferIndex = 0;
         size_t imageIndex = 0;
         for (auto& write : m_writes) {
-            if (write.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
-                write.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
+            if (isBufferDescriptor(write.descriptorType)) {
                 write.pBufferInfo = &m_bufferInfos[bufferIndex++];
             }
-            else if (write.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
-                write.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE) {
+            else if (isImageDescriptor(write.descriptorType)) {
                 write.pImageInfo = &m_imageInfos[imageIndex++];
             }
         }
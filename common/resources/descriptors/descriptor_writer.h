@@ -4,13 +4,18 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 
+#include "resources/descriptors/descriptor_key.h"
+
 namespace vkcommon {
 
     class Device;
+    class DescriptorSetLayout;
 
     class DescriptorWriter {
     public:
         DescriptorWriter(VkDescriptorSet descriptorSet);
+        // Collects writes for a set picked later, e.g. by DescriptorSetCache
+        DescriptorWriter() : DescriptorWriter(VK_NULL_HANDLE) {}
 
         DescriptorWriter& writeBuffer(uint32_t binding,
             VkDescriptorType type,
@@ -22,9 +27,24 @@ namespace vkcommon {
             VkDescriptorType type,
             VkImageView imageView,
             VkSampler sampler,
-            VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            uint32_t arrayElement = 0);
 
         void update(const Device& device);
+        // Writes into descriptorSet instead of the set given at construction
+        void update(const Device& device, VkDescriptorSet descriptorSet);
+
+        // A single vkUpdateDescriptorSetWithTemplate through the layout's
+        // template for the bindings written. The set must have been allocated
+        // with layout. Writes past array element 0 or repeating a binding
+        // fall back to update(device).
+        void update(const Device& device, const DescriptorSetLayout& layout);
+        void update(const Device& device, const DescriptorSetLayout& layout, VkDescriptorSet descriptorSet);
+
+        // Bindings, types and resources written, not the target set
+        DescriptorKey key() const;
+        // Buffers, image views and samplers written, see descriptorHandleBits
+        std::vector<uint64_t> resourceHandles() const;
 
     private:
         VkDescriptorSet m_descriptorSet;
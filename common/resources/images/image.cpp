@@ -1,8 +1,7 @@
 #include "image.h"
 
 #include "core/device.h"
-#include "graphics/command_pool.h"
-#include "resources/buffers/buffer.h"
+#include "graphics/upload_context.h"
 #include "resources/memory/memory_allocator.h"
 
 #include <stdexcept>
@@ -23,10 +22,7 @@ namespace vkcommon {
             m_image = VK_NULL_HANDLE;
         }
 
-        if (m_memory != VK_NULL_HANDLE) {
-            m_allocatorRef.freeMemory(m_memory);
-            m_memory = VK_NULL_HANDLE;
-        }
+        m_allocatorRef.free(m_allocation);
 
         m_format = VK_FORMAT_UNDEFINED;
         m_mipLevels = 1;
@@ -38,13 +34,13 @@ namespace vkcommon {
         : m_deviceRef(other.m_deviceRef)
         , m_allocatorRef(other.m_allocatorRef)
         , m_image(other.m_image)
-        , m_memory(other.m_memory)
+        , m_allocation(other.m_allocation)
         , m_format(other.m_format)
         , m_mipLevels(other.m_mipLevels)
         , m_extent(other.m_extent)
         , m_currentLayout(other.m_currentLayout) {
         other.m_image = VK_NULL_HANDLE;
-        other.m_memory = VK_NULL_HANDLE;
+        other.m_allocation = {};
         other.m_format = VK_FORMAT_UNDEFINED;
         other.m_mipLevels = 1;
         other.m_extent = { 0, 0 };
@@ -56,14 +52,14 @@ namespace vkcommon {
             cleanup();
 
             m_image = other.m_image;
-            m_memory = other.m_memory;
+            m_allocation = other.m_allocation;
             m_format = other.m_format;
             m_mipLevels = other.m_mipLevels;
             m_extent = other.m_extent;
             m_currentLayout = other.m_currentLayout;
 
             other.m_image = VK_NULL_HANDLE;
-            other.m_memory = VK_NULL_HANDLE;
+            other.m_allocation = {};
             other.m_format = VK_FORMAT_UNDEFINED;
             other.m_mipLevels = 1;
             other.m_extent = { 0, 0 };
@@ -103,15 +99,18 @@ namespace vkcommon {
         VkMemoryRequirements memRequirements;
         vkGetImageMemoryRequirements(m_deviceRef.handle(), m_image, &memRequirements);
 
-        m_memory = m_allocatorRef.allocateMemoryForRequirements(memRequirements, properties);
+        m_allocation = m_allocatorRef.allocate(memRequirements, properties, tiling == VK_IMAGE_TILING_LINEAR);
 
-        if (vkBindImageMemory(m_deviceRef.handle(), m_image, m_memory, 0) != VK_SUCCESS) {
+        if (vkBindImageMemory(m_deviceRef.handle(), m_image, m_allocation.memory, m_allocation.offset) != VK_SUCCESS) {
             throw std::runtime_error("Failed to bind image memory");
         }
     }
 
-    void Image::transitionLayout(VkImageLayout newLayout, const CommandPool& cmdPool) {
-        VkCommandBuffer commandBuffer = cmdPool.beginSingleTimeCommand();
+    void Image::transitionLayout(VkImageLayout newLayout, UploadContext& uploadContext) {
+        // Only the transition into TRANSFER_DST can run on a transfer-only queue
+        VkCommandBuffer commandBuffer = newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+            ? uploadContext.transferCommandBuffer()
+            : uploadContext.graphicsCommandBuffer();
 
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -156,32 +155,29 @@ namespace vkcommon {
             1, &barrier
         );
 
-        cmdPool.endSingleTimeCommand(commandBuffer, m_deviceRef.graphicsQueue());
         m_currentLayout = newLayout;
     }
 
-    void Image::copyFromBuffer(const Buffer& buffer, uint32_t width, uint32_t height,
-        const CommandPool& cmdPool) {
-        VkCommandBuffer commandBuffer = cmdPool.beginSingleTimeCommand();
+    void Image::copyFromBuffer(VkBuffer buffer, VkDeviceSize bufferOffset, uint32_t width, uint32_t height,
+        uint32_t rowOffset, UploadContext& uploadContext) {
+        VkCommandBuffer commandBuffer = uploadContext.transferCommandBuffer();
 
         VkBufferImageCopy region{};
-        region.bufferOffset = 0;
+        region.bufferOffset = bufferOffset;
         region.bufferRowLength = 0;
         region.bufferImageHeight = 0;
         region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         region.imageSubresource.mipLevel = 0;
         region.imageSubresource.baseArrayLayer = 0;
         region.imageSubresource.layerCount = 1;
-        region.imageOffset = { 0, 0, 0 };
+        region.imageOffset = { 0, static_cast<int32_t>(rowOffset), 0 };
         region.imageExtent = {
             width,
             height,
             1
         };
 
-        vkCmdCopyBufferToImage(commandBuffer, buffer.handle(), m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-        cmdPool.endSingleTimeCommand(commandBuffer, m_deviceRef.graphicsQueue());
+        vkCmdCopyBufferToImage(commandBuffer, buffer, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
     }
 
     VkImageView Image::createView(VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels) {
@@ -3,10 +3,11 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include "resources/memory/memory_allocator.h"
+
 namespace vkcommon {
     class Device;
-    class CommandPool;
-    class Buffer;
+    class UploadContext;
     class MemoryAllocator;
 
     class Image {
@@ -31,20 +32,25 @@ namespace vkcommon {
             VkImageUsageFlags usage,
             VkMemoryPropertyFlags properties);
 
+        // Recorded into the upload context, executed when it is flushed
         void transitionLayout(VkImageLayout newLayout,
-            const CommandPool& cmdPool);
+            UploadContext& uploadContext);
 
-        void copyFromBuffer(const Buffer& buffer,
+        // Copies rows [rowOffset, rowOffset + height) of mip 0 from tightly packed buffer data
+        void copyFromBuffer(VkBuffer buffer,
+            VkDeviceSize bufferOffset,
             uint32_t width,
             uint32_t height,
-            const CommandPool& cmdPool);
+            uint32_t rowOffset,
+            UploadContext& uploadContext);
 
         VkImageView createView(VkFormat format,
             VkImageAspectFlags aspectFlags,
             uint32_t mipLevels = 1);
 
         VkImage handle() const { return m_image; }
-        VkDeviceMemory memory() const { return m_memory; }
+        VkDeviceMemory memory() const { return m_allocation.memory; }
+        VkDeviceSize memoryOffset() const { return m_allocation.offset; }
         VkFormat format() const { return m_format; }
         uint32_t mipLevels() const { return m_mipLevels; }
         VkExtent2D extent() const { return m_extent; }
@@ -55,7 +61,7 @@ namespace vkcommon {
 
     private:
         VkImage m_image{ VK_NULL_HANDLE };
-        VkDeviceMemory m_memory{ VK_NULL_HANDLE };
+        Allocation m_allocation{};
         VkFormat m_format{ VK_FORMAT_UNDEFINED };
         uint32_t m_mipLevels{ 1 };
         VkExtent2D m_extent{ 0, 0 };
@@ -2,7 +2,7 @@
 
 #include "core/physical_device.h"
 #include "core/device.h"
-#include "graphics/command_pool.h"
+#include "graphics/upload_context.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -29,8 +29,6 @@ namespace vkcommon {
             vkDestroyImageView(m_deviceRef.handle(), m_imageView, nullptr);
             m_imageView = VK_NULL_HANDLE;
         }
-
-        m_stagingBuffer.reset();
     }
 
     Texture::Texture(Texture&& other) noexcept
@@ -38,8 +36,7 @@ namespace vkcommon {
         , m_allocatorRef(other.m_allocatorRef)
         , m_image(std::move(other.m_image))
         , m_imageView(other.m_imageView)
-        , m_sampler(other.m_sampler)
-        , m_stagingBuffer(std::move(other.m_stagingBuffer)) {
+        , m_sampler(other.m_sampler) {
         other.m_imageView = VK_NULL_HANDLE;
         other.m_sampler = VK_NULL_HANDLE;
     }
@@ -51,7 +48,6 @@ namespace vkcommon {
             m_image = std::move(other.m_image);
             m_imageView = other.m_imageView;
             m_sampler = other.m_sampler;
-            m_stagingBuffer = std::move(other.m_stagingBuffer);
 
             other.m_imageView = VK_NULL_HANDLE;
             other.m_sampler = VK_NULL_HANDLE;
@@ -59,7 +55,7 @@ namespace vkcommon {
         return *this;
     }
 
-    void Texture::loadFromFile(const std::filesystem::path& filepath, const CommandPool& commandPool) {
+    void Texture::loadFromFile(const std::filesystem::path& filepath, UploadContext& uploadContext) {
         int texWidth, texHeight, texChannels;
         stbi_uc* pixels = stbi_load(filepath.string().c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
@@ -67,19 +63,8 @@ namespace vkcommon {
             throw std::runtime_error("failed to load texture image!");
         }
 
-        VkDeviceSize imageSize = texWidth * texHeight * 4;
-
         uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
 
-        m_stagingBuffer = std::make_unique<Buffer>(m_deviceRef, m_allocatorRef);
-        m_stagingBuffer->create(
-            imageSize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-        m_stagingBuffer->update(pixels, imageSize);
-        stbi_image_free(pixels);
-
         m_image.create(
             texWidth,
             texHeight,
@@ -94,14 +79,15 @@ namespace vkcommon {
         // Transition image to be ready for copy
         m_image.transitionLayout(
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            commandPool
+            uploadContext
         );
 
-        // Copy from staging buffer to image
-        m_image.copyFromBuffer(*m_stagingBuffer, texWidth, texHeight, commandPool);
+        // Copy pixels to image through the staging ring
+        uploadContext.uploadImage(m_image, pixels, texWidth, texHeight, 4);
+        stbi_image_free(pixels);
 
         // Generate mipmaps
-        generateMipMaps(commandPool);
+        generateMipMaps(uploadContext);
 
         // Create image view
         m_imageView = m_image.createView(
@@ -109,9 +95,6 @@ namespace vkcommon {
             VK_IMAGE_ASPECT_COLOR_BIT,
             mipLevels
         );
-
-        // Cleanup staging buffer
-        m_stagingBuffer.reset();
     }
 
     void Texture::createSampler(float maxAnisotropy,
@@ -142,14 +125,15 @@ namespace vkcommon {
         }
     }
 
-    void Texture::generateMipMaps(const CommandPool& cmdPool) {
+    void Texture::generateMipMaps(UploadContext& uploadContext) {
         VkFormatProperties formatProperties = m_deviceRef.physicalDeviceFormatProperties(m_image.format());
 
         if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
             throw std::runtime_error("Texture image format does not support linear blitting!");
         }
 
-        VkCommandBuffer commandBuffer = cmdPool.beginSingleTimeCommand();
+        // Blits need a graphics queue
+        VkCommandBuffer commandBuffer = uploadContext.graphicsCommandBuffer();
 
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -226,8 +210,6 @@ namespace vkcommon {
             0, nullptr,
             0, nullptr,
             1, &barrier);
-
-        cmdPool.endSingleTimeCommand(commandBuffer, m_deviceRef.graphicsQueue());
     }
 } // namespace vkcommon
 
@@ -13,7 +13,7 @@
 namespace vkcommon {
 
     class Device;
-    class CommandPool;
+    class UploadContext;
     class MemoryAllocator;
 
     class Texture {
@@ -29,8 +29,8 @@ namespace vkcommon {
         Texture(Texture&& other) noexcept;
         Texture& operator=(Texture&& other) noexcept;
 
-        // Load texture from file
-        void loadFromFile(const std::filesystem::path& filepath, const CommandPool& commandPool);
+        // Load texture from file; the GPU work runs when the upload context is flushed
+        void loadFromFile(const std::filesystem::path& filepath, UploadContext& uploadContext);
 
         void createSampler(float maxAnisotropy = 16.0f,
             VkFilter minFilter = VK_FILTER_LINEAR,
@@ -45,11 +45,9 @@ namespace vkcommon {
         VkFormat format() const { return m_image.format(); }
 
     private:
-        void generateMipMaps(const CommandPool& cmdPool);
+        void generateMipMaps(UploadContext& uploadContext);
         void cleanup();
 
-        std::unique_ptr<Buffer> m_stagingBuffer;
-
         Image m_image;
         VkImageView m_imageView{ VK_NULL_HANDLE };
         VkSampler m_sampler{ VK_NULL_HANDLE };
@@ -3,12 +3,24 @@
 #include "core/physical_device.h"
 #include "core/device.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace vkcommon {
     MemoryAllocator::MemoryAllocator(const PhysicalDevice& physicalDevice, const Device& device)
         : m_deviceRef(device) {
         vkGetPhysicalDeviceMemoryProperties(physicalDevice.handle(), &m_memProperties);
+        m_bufferImageGranularity = physicalDevice.properties().limits.bufferImageGranularity;
+        m_nonCoherentAtomSize = physicalDevice.properties().limits.nonCoherentAtomSize;
+    }
+
+    MemoryAllocator::~MemoryAllocator() {
+        for (auto& blocks : m_blocks) {
+            for (auto& block : blocks) {
+                freeMemory(block->memory);
+            }
+            blocks.clear();
+        }
     }
 
     uint32_t MemoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
@@ -35,17 +47,173 @@ namespace vkcommon {
     }
 
     void MemoryAllocator::freeMemory(VkDeviceMemory memory) const {
+        // Mapped memory is implicitly unmapped when freed
         if (memory != VK_NULL_HANDLE) {
             vkFreeMemory(m_deviceRef.handle(), memory, nullptr);
         }
     }
 
-    VkDeviceMemory MemoryAllocator::allocateMemoryForRequirements(
+    bool MemoryAllocator::isHostCoherent(uint32_t memoryTypeIndex) const {
+        return m_memProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    }
+
+    void* MemoryAllocator::mapIfHostVisible(VkDeviceMemory memory, uint32_t memoryTypeIndex) const {
+        if (!(m_memProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+            return nullptr;
+        }
+
+        void* mapped;
+        if (vkMapMemory(m_deviceRef.handle(), memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to map memory");
+        }
+        return mapped;
+    }
+
+    VkDeviceSize MemoryAllocator::blockSizeForType(uint32_t memoryTypeIndex) const {
+        uint32_t heapIndex = m_memProperties.memoryTypes[memoryTypeIndex].heapIndex;
+        VkDeviceSize heapSize = m_memProperties.memoryHeaps[heapIndex].size;
+
+        // Small heaps (e.g. the 256 MiB BAR window) get proportionally smaller blocks
+        if (heapSize <= 1024ull * 1024 * 1024) {
+            return heapSize / 8;
+        }
+        return kDefaultBlockSize;
+    }
+
+    MemoryBlock& MemoryAllocator::createBlock(uint32_t memoryTypeIndex) {
+        VkDeviceSize blockSize = blockSizeForType(memoryTypeIndex);
+        VkDeviceMemory memory = allocateMemory(blockSize, memoryTypeIndex);
+
+        auto& blocks = m_blocks[memoryTypeIndex];
+        blocks.push_back(std::make_unique<MemoryBlock>(MemoryBlock{
+            memory,
+            memoryTypeIndex,
+            RangeAllocator(blockSize, m_bufferImageGranularity),
+            mapIfHostVisible(memory, memoryTypeIndex) }));
+        return *blocks.back();
+    }
+
+    Allocation MemoryAllocator::allocate(
         const VkMemoryRequirements& memRequirements,
-        VkMemoryPropertyFlags properties) const {
+        VkMemoryPropertyFlags properties,
+        bool linear) {
 
         uint32_t memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-        return allocateMemory(memRequirements.size, memoryTypeIndex);
+
+        Allocation allocation{};
+        allocation.size = memRequirements.size;
+        allocation.memoryTypeIndex = memoryTypeIndex;
+
+        // Resources larger than half a block get their own memory object
+        if (memRequirements.size > blockSizeForType(memoryTypeIndex) / 2) {
+            allocation.memory = allocateMemory(memRequirements.size, memoryTypeIndex);
+            allocation.mapped = mapIfHostVisible(allocation.memory, memoryTypeIndex);
+            return allocation;
+        }
+
+        // flush() and invalidate() widen ranges on non-coherent memory to whole
+        // atoms, so no two allocations may share one
+        VkDeviceSize rangeSize = memRequirements.size;
+        VkDeviceSize alignment = memRequirements.alignment;
+        bool hostVisible = m_memProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        if (hostVisible && !isHostCoherent(memoryTypeIndex)) {
+            VkDeviceSize atom = m_nonCoherentAtomSize;
+            rangeSize = (rangeSize + atom - 1) / atom * atom;
+            // Both are powers of two, so the larger one satisfies both
+            alignment = std::max(alignment, atom);
+        }
+
+        for (auto& block : m_blocks[memoryTypeIndex]) {
+            if (auto offset = block->ranges.allocate(rangeSize, alignment, linear)) {
+                allocation.memory = block->memory;
+                allocation.offset = *offset;
+                allocation.block = block.get();
+                if (block->mapped) {
+                    allocation.mapped = static_cast<char*>(block->mapped) + *offset;
+                }
+                return allocation;
+            }
+        }
+
+        MemoryBlock& block = createBlock(memoryTypeIndex);
+        auto offset = block.ranges.allocate(rangeSize, alignment, linear);
+        if (!offset) {
+            throw std::runtime_error("Failed to sub-allocate memory");
+        }
+
+        allocation.memory = block.memory;
+        allocation.offset = *offset;
+        allocation.block = &block;
+        if (block.mapped) {
+            allocation.mapped = static_cast<char*>(block.mapped) + *offset;
+        }
+        return allocation;
+    }
+
+    void MemoryAllocator::free(Allocation& allocation) {
+        if (!allocation.valid()) {
+            return;
+        }
+
+        if (allocation.block == nullptr) {
+            freeMemory(allocation.memory);
+        }
+        else {
+            MemoryBlock* block = allocation.block;
+            block->ranges.free(allocation.offset);
+
+            // Keep one empty block per memory type around to avoid allocation churn
+            auto& blocks = m_blocks[allocation.memoryTypeIndex];
+            if (block->ranges.empty() && blocks.size() > 1) {
+                freeMemory(block->memory);
+                std::erase_if(blocks, [block](const std::unique_ptr<MemoryBlock>& b) {
+                    return b.get() == block;
+                });
+            }
+        }
+
+        allocation = {};
+    }
+
+    VkMappedMemoryRange MemoryAllocator::mappedRange(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const {
+        VkDeviceSize memorySize = allocation.block ? allocation.block->ranges.size() : allocation.size;
+        if (size == VK_WHOLE_SIZE) {
+            size = allocation.size - offset;
+        }
+
+        // Ranges on non-coherent memory must be multiples of nonCoherentAtomSize
+        VkDeviceSize atom = m_nonCoherentAtomSize;
+        VkDeviceSize begin = (allocation.offset + offset) / atom * atom;
+        VkDeviceSize end = std::min((allocation.offset + offset + size + atom - 1) / atom * atom, memorySize);
+
+        VkMappedMemoryRange range{};
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = allocation.memory;
+        range.offset = begin;
+        range.size = end - begin;
+        return range;
+    }
+
+    void MemoryAllocator::flush(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const {
+        if (!allocation.valid() || isHostCoherent(allocation.memoryTypeIndex)) {
+            return;
+        }
+
+        VkMappedMemoryRange range = mappedRange(allocation, offset, size);
+        if (vkFlushMappedMemoryRanges(m_deviceRef.handle(), 1, &range) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to flush mapped memory");
+        }
+    }
+
+    void MemoryAllocator::invalidate(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const {
+        if (!allocation.valid() || isHostCoherent(allocation.memoryTypeIndex)) {
+            return;
+        }
+
+        VkMappedMemoryRange range = mappedRange(allocation, offset, size);
+        if (vkInvalidateMappedMemoryRanges(m_deviceRef.handle(), 1, &range) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to invalidate mapped memory");
+        }
     }
 
 } // namespace vkcommon
\ No newline at end of file
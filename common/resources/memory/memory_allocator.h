@@ -1,17 +1,45 @@
 #ifndef MEMORY_ALLOCATOR_H
 #define MEMORY_ALLOCATOR_H
 
+#include "range_allocator.h"
+
 #include <vulkan/vulkan.h>
 
+#include <array>
+#include <memory>
+#include <vector>
+
 namespace vkcommon {
 
     class PhysicalDevice;
     class Device;
 
+    // A large VkDeviceMemory that resources are sub-allocated from
+    struct MemoryBlock {
+        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        uint32_t memoryTypeIndex{ 0 };
+        RangeAllocator ranges;
+        void* mapped{ nullptr }; // Mapped once at creation for host-visible types
+    };
+
+    // Handle to a sub-range of a MemoryBlock, or to a dedicated VkDeviceMemory
+    struct Allocation {
+        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        VkDeviceSize offset{ 0 };
+        VkDeviceSize size{ 0 };
+        uint32_t memoryTypeIndex{ 0 };
+        MemoryBlock* block{ nullptr }; // nullptr for dedicated allocations
+        void* mapped{ nullptr }; // Persistent host pointer to offset, nullptr if not host-visible
+
+        bool valid() const { return memory != VK_NULL_HANDLE; }
+    };
+
     class MemoryAllocator {
     public:
+        static constexpr VkDeviceSize kDefaultBlockSize = 64ull * 1024 * 1024;
+
         explicit MemoryAllocator(const PhysicalDevice& physicalDevice, const Device& device);
-        ~MemoryAllocator() = default;
+        ~MemoryAllocator();
 
         // Disable copying
         MemoryAllocator(const MemoryAllocator&) = delete;
@@ -22,12 +50,31 @@ namespace vkcommon {
         VkDeviceMemory allocateMemory(VkDeviceSize size, uint32_t memoryTypeIndex) const;
         void freeMemory(VkDeviceMemory memory) const;
 
-        VkDeviceMemory allocateMemoryForRequirements(
+        // Sub-allocates from a shared block; linear is false only for optimal-tiling images
+        Allocation allocate(
             const VkMemoryRequirements& memRequirements,
-            VkMemoryPropertyFlags properties) const;
+            VkMemoryPropertyFlags properties,
+            bool linear = true);
+        void free(Allocation& allocation);
+
+        // No-ops for HOST_COHERENT memory; offset is relative to the allocation
+        void flush(const Allocation& allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+        void invalidate(const Allocation& allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+        bool isHostCoherent(uint32_t memoryTypeIndex) const;
+
     private:
+        VkDeviceSize blockSizeForType(uint32_t memoryTypeIndex) const;
+        MemoryBlock& createBlock(uint32_t memoryTypeIndex);
+        void* mapIfHostVisible(VkDeviceMemory memory, uint32_t memoryTypeIndex) const;
+        VkMappedMemoryRange mappedRange(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+
         const Device& m_deviceRef;
         VkPhysicalDeviceMemoryProperties m_memProperties;
+        VkDeviceSize m_bufferImageGranularity{ 1 };
+        VkDeviceSize m_nonCoherentAtomSize{ 1 };
+
+        std::array<std::vector<std::unique_ptr<MemoryBlock>>, VK_MAX_MEMORY_TYPES> m_blocks;
     };
 } // namespace vkcommon
 
@@ -0,0 +1,116 @@
+#include "range_allocator.h"
+
+#include <iterator>
+#include <stdexcept>
+
+namespace vkcommon {
+
+    namespace {
+        VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    RangeAllocator::RangeAllocator(VkDeviceSize size, VkDeviceSize granularity)
+        : m_size(size)
+        , m_granularity(granularity > 0 ? granularity : 1) {
+        m_ranges.emplace(0, Range{ size, true, false });
+    }
+
+    bool RangeAllocator::onSamePage(VkDeviceSize endOfFirst, VkDeviceSize startOfSecond) const {
+        // Granularity is guaranteed to be a power of two by the spec
+        VkDeviceSize pageMask = ~(m_granularity - 1);
+        return (endOfFirst & pageMask) == (startOfSecond & pageMask);
+    }
+
+    std::optional<VkDeviceSize> RangeAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment, bool linear) {
+        if (size == 0) {
+            return std::nullopt;
+        }
+        if (alignment == 0) {
+            alignment = 1;
+        }
+
+        auto best = m_ranges.end();
+        VkDeviceSize bestOffset = 0;
+
+        // Best fit: the smallest free range that can hold the aligned request
+        for (auto it = m_ranges.begin(); it != m_ranges.end(); ++it) {
+            const Range& range = it->second;
+            if (!range.free || range.size < size) {
+                continue;
+            }
+
+            VkDeviceSize offset = alignUp(it->first, alignment);
+
+            if (it != m_ranges.begin()) {
+                auto prev = std::prev(it);
+                if (!prev->second.free && prev->second.linear != linear &&
+                    onSamePage(it->first - 1, offset)) {
+                    offset = alignUp(offset, m_granularity);
+                }
+            }
+
+            if (offset + size > it->first + range.size) {
+                continue;
+            }
+
+            auto next = std::next(it);
+            if (next != m_ranges.end() && !next->second.free && next->second.linear != linear &&
+                onSamePage(offset + size - 1, next->first)) {
+                continue;
+            }
+
+            if (best == m_ranges.end() || range.size < best->second.size) {
+                best = it;
+                bestOffset = offset;
+            }
+        }
+
+        if (best == m_ranges.end()) {
+            return std::nullopt;
+        }
+
+        VkDeviceSize start = best->first;
+        VkDeviceSize end = start + best->second.size;
+        m_ranges.erase(best);
+
+        if (bestOffset > start) {
+            m_ranges.emplace(start, Range{ bestOffset - start, true, false });
+        }
+        m_ranges.emplace(bestOffset, Range{ size, false, linear });
+        if (bestOffset + size < end) {
+            m_ranges.emplace(bestOffset + size, Range{ end - bestOffset - size, true, false });
+        }
+
+        m_used += size;
+        return bestOffset;
+    }
+
+    void RangeAllocator::free(VkDeviceSize offset) {
+        auto it = m_ranges.find(offset);
+        if (it == m_ranges.end() || it->second.free) {
+            throw std::runtime_error("Failed to free range: offset was not allocated");
+        }
+
+        m_used -= it->second.size;
+        it->second.free = true;
+        it->second.linear = false;
+
+        // Merge with free neighbours so free ranges never touch
+        auto next = std::next(it);
+        if (next != m_ranges.end() && next->second.free) {
+            it->second.size += next->second.size;
+            m_ranges.erase(next);
+        }
+
+        if (it != m_ranges.begin()) {
+            auto prev = std::prev(it);
+            if (prev->second.free) {
+                prev->second.size += it->second.size;
+                m_ranges.erase(it);
+            }
+        }
+    }
+
+} // namespace vkcommon
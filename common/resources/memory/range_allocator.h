@@ -0,0 +1,55 @@
+#ifndef RANGE_ALLOCATOR_H
+#define RANGE_ALLOCATOR_H
+
+#include <vulkan/vulkan_core.h>
+
+#include <map>
+#include <optional>
+
+namespace vkcommon {
+
+    // Pure CPU bookkeeping for sub-ranges of a single memory block.
+    // Tracks whether each range holds a linear (buffer / linear image) or an
+    // optimal-tiling resource so neighbours of different kinds never share a
+    // bufferImageGranularity page.
+    class RangeAllocator {
+    public:
+        explicit RangeAllocator(VkDeviceSize size, VkDeviceSize granularity = 1);
+        ~RangeAllocator() = default;
+
+        // Disable copying
+        RangeAllocator(const RangeAllocator&) = delete;
+        RangeAllocator& operator=(const RangeAllocator&) = delete;
+
+        // Enable moving
+        RangeAllocator(RangeAllocator&& other) noexcept = default;
+        RangeAllocator& operator=(RangeAllocator&& other) noexcept = default;
+
+        // Returns the offset of the new range, or nothing if no free range fits
+        std::optional<VkDeviceSize> allocate(VkDeviceSize size, VkDeviceSize alignment, bool linear);
+        void free(VkDeviceSize offset);
+
+        VkDeviceSize size() const { return m_size; }
+        VkDeviceSize used() const { return m_used; }
+        bool empty() const { return m_used == 0; }
+
+    private:
+        struct Range {
+            VkDeviceSize size;
+            bool free;
+            bool linear;
+        };
+
+        bool onSamePage(VkDeviceSize endOfFirst, VkDeviceSize startOfSecond) const;
+
+        VkDeviceSize m_size;
+        VkDeviceSize m_granularity;
+        VkDeviceSize m_used{ 0 };
+
+        // Ranges keyed by offset, always covering [0, m_size) without gaps
+        std::map<VkDeviceSize, Range> m_ranges;
+    };
+
+} // namespace vkcommon
+
+#endif // RANGE_ALLOCATOR_H
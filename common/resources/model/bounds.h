@@ -0,0 +1,25 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <glm/glm.hpp>
+
+namespace vkcommon {
+
+    // Axis-aligned box in model space
+    struct BoundingBox {
+        glm::vec3 min{ 0.0f };
+        glm::vec3 max{ 0.0f };
+
+        glm::vec3 center() const { return (min + max) * 0.5f; }
+        glm::vec3 extent() const { return (max - min) * 0.5f; }
+    };
+
+    // Model-space sphere, laid out as the vec4 read by the culling shader
+    struct BoundingSphere {
+        glm::vec3 center{ 0.0f };
+        float radius{ 0.0f };
+    };
+
+} // namespace vkcommon
+
+#endif // BOUNDS_H
@@ -0,0 +1,35 @@
+#include "frustum.h"
+
+namespace vkcommon {
+
+    Frustum Frustum::fromMatrix(const glm::mat4& viewProj) {
+        // glm is column-major, row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+        glm::mat4 m = glm::transpose(viewProj);
+
+        Frustum frustum;
+        frustum.m_planes[0] = m[3] + m[0];  // Left
+        frustum.m_planes[1] = m[3] - m[0];  // Right
+        frustum.m_planes[2] = m[3] + m[1];  // Bottom
+        frustum.m_planes[3] = m[3] - m[1];  // Top
+        // Assumes a [-1, 1] depth range like glm::perspective by default; with
+        // [0, 1] depth this near plane is looser, which never culls visible meshes
+        frustum.m_planes[4] = m[3] + m[2];  // Near
+        frustum.m_planes[5] = m[3] - m[2];  // Far
+
+        for (auto& plane : frustum.m_planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+
+        return frustum;
+    }
+
+    bool Frustum::intersects(const BoundingSphere& sphere) const {
+        for (const auto& plane : m_planes) {
+            if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace vkcommon
@@ -0,0 +1,33 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+#include "resources/model/bounds.h"
+
+namespace vkcommon {
+
+    // Six planes (left, right, bottom, top, near, far) with inward normals,
+    // a point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0.
+    // CPU reference of the test done by the culling shader.
+    class Frustum {
+    public:
+        Frustum() = default;
+
+        // Extracts normalized planes from a projection * view * model matrix,
+        // so the planes are in model space and bounds need no transform
+        static Frustum fromMatrix(const glm::mat4& viewProj);
+
+        bool intersects(const BoundingSphere& sphere) const;
+
+        const std::array<glm::vec4, 6>& planes() const { return m_planes; }
+
+    private:
+        std::array<glm::vec4, 6> m_planes{};
+    };
+
+} // namespace vkcommon
+
+#endif // FRUSTUM_H
@@ -1,100 +1,85 @@
 #include "material.h"
 
 #include "core/device.h"
-#include "resources/memory/memory_allocator.h"
+#include "graphics/shader_reflection.h"
 #include "resources/images/texture.h"
-#include "resources/buffers/uniform_buffer.h"
 #include "resources/descriptors/descriptor_set_layout.h"
-#include "resources/descriptors/descriptor_pool.h"
+#include "resources/descriptors/descriptor_set_layout_cache.h"
+#include "resources/descriptors/descriptor_set_cache.h"
 #include "resources/descriptors/descriptor_writer.h"
 
 #include <stdexcept>
 
 namespace vkcommon {
-    std::unique_ptr<DescriptorSetLayout> Material::s_descriptorSetLayout;
+    const DescriptorSetLayout* Material::s_descriptorSetLayout{ nullptr };
 
-    Material::Material(const Device& device, MemoryAllocator& allocator)
+    Material::Material(const Device& device)
         : m_deviceRef(device) {
         m_properties = {};
-        m_ubo = std::make_unique<UniformBuffer>(m_deviceRef, allocator);
     }
 
     void Material::createDescriptorSetLayout(const Device& device) {
-
-        auto layout = std::make_unique<DescriptorSetLayout>(device);
-        
-        // Material's properties 
-        layout->addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT);
         // Material's textures
-        layout->addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            VK_SHADER_STAGE_FRAGMENT_BIT); // Diffuse
-        layout->addBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            VK_SHADER_STAGE_FRAGMENT_BIT); // Specular
-        layout->addBinding(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            VK_SHADER_STAGE_FRAGMENT_BIT); // Normal
+        s_descriptorSetLayout = &device.descriptorSetLayoutCache().get({
+            DescriptorSetLayoutCache::binding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                VK_SHADER_STAGE_FRAGMENT_BIT), // Diffuse
+            DescriptorSetLayoutCache::binding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                VK_SHADER_STAGE_FRAGMENT_BIT), // Specular
+            DescriptorSetLayoutCache::binding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                VK_SHADER_STAGE_FRAGMENT_BIT)  // Normal
+        });
+    }
 
-        layout->create();
-        
-        // set the static layout by moving the created layout
-        s_descriptorSetLayout = std::move(layout);
+    void Material::createDescriptorSetLayout(const Device& device, const ShaderReflection& reflection) {
+        s_descriptorSetLayout = &device.descriptorSetLayoutCache().get(reflection.layoutBindings(1));
     }
 
     void Material::destroyDescriptorSetLayout()
     {
-        s_descriptorSetLayout.reset();
+        // The layout itself goes with the device's cache
+        s_descriptorSetLayout = nullptr;
     }
 
-    void Material::createDescriptorSets(DescriptorPool& pool, const DescriptorSetLayout& layout, uint32_t framesInFlight)
+    void Material::createDescriptorSet(DescriptorSetCache& setCache, const DescriptorSetLayout& layout)
     {
-        m_descriptorSets = pool.allocate(layout.handle(), framesInFlight);
-
-        for (uint32_t frameIndex = 0; frameIndex < framesInFlight; frameIndex++) {
-            DescriptorWriter writer{ m_descriptorSets[frameIndex] };
+        // Shared textures come from the TextureLibrary, so equal maps have equal views
+        DescriptorWriter writer;
 
-            writer.writeBuffer(
+        if (m_diffuseMap != nullptr) {
+            writer.writeImage(
                 0,
-                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                m_ubo->buffer(frameIndex),
-                sizeof(MaterialProperties));
-
-            if (m_diffuseMap != nullptr) {
-                writer.writeImage(
-                    1,
-                    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                    m_diffuseMap->imageView(),
-                    m_diffuseMap->sampler());
-            }
-
-            if (m_specularMap != nullptr) {
-                writer.writeImage(
-                    2,
-                    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                    m_specularMap->imageView(),
-                    m_specularMap->sampler());
-            }
-
-            if (m_normalMap != nullptr) {
-                writer.writeImage(
-                    3,
-                    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                    m_normalMap->imageView(),
-                    m_normalMap->sampler());
-            }
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                m_diffuseMap->imageView(),
+                m_diffuseMap->sampler());
+        }
 
-            writer.update(m_deviceRef);
+        if (m_specularMap != nullptr) {
+            writer.writeImage(
+                1,
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                m_specularMap->imageView(),
+                m_specularMap->sampler());
         }
 
-    }
+        if (m_normalMap != nullptr) {
+            writer.writeImage(
+                2,
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                m_normalMap->imageView(),
+                m_normalMap->sampler());
+        }
 
-    void Material::createPropertiesUBO(const int MAX_FRAMES_IN_FLIGHT) {
-        m_ubo->create(sizeof(MaterialProperties), MAX_FRAMES_IN_FLIGHT);
+        m_descriptorSet = setCache.get(layout, writer);
     }
 
-    void Material::updateProperties(uint32_t currentFrame) {
-        if (m_ubo == nullptr) {
-            throw std::runtime_error("Material UBO is not created!");
-        }
-        m_ubo->updateData(currentFrame, &m_properties, sizeof(MaterialProperties));
+    SpecializationConstants Material::specialization() const
+    {
+        SpecializationConstants constants;
+        constants
+            .set(kHasDiffuseMapId, m_diffuseMap != nullptr)
+            .set(kHasSpecularMapId, m_specularMap != nullptr)
+            .set(kHasNormalMapId, m_normalMap != nullptr);
+        return constants;
     }
 
     //void Material::updateTextures(uint32_t currentFrame)
@@ -7,15 +7,18 @@
 
 #include <vulkan/vulkan.h>
 
+#include "graphics/specialization_constants.h"
+#include "resources/descriptors/bindless_texture_table.h"
+
 namespace vkcommon {
 
-    class UniformBuffer;
     class Texture;
     class Device;
-    class MemoryAllocator;
-    class DescriptorPool;
+    class DescriptorSetCache;
     class DescriptorSetLayout;
+    class ShaderReflection;
 
+    // std430 element of the model's material storage buffer
     struct MaterialProperties {
         alignas(16) glm::vec4 ambientColor;
         alignas(16) glm::vec4 diffuseColor;
@@ -24,11 +27,15 @@ namespace vkcommon {
         alignas(4) float shininess;
         alignas(4) float opacity;
         alignas(4) float refractiveIndex;
+        // Slots in the TextureLibrary's bindless table, read by the bindless shader only
+        alignas(4) uint32_t diffuseTexture{ BindlessTextureTable::kNoTexture };
+        alignas(4) uint32_t specularTexture{ BindlessTextureTable::kNoTexture };
+        alignas(4) uint32_t normalTexture{ BindlessTextureTable::kNoTexture };
     };
 
     class Material {
     public:
-        Material(const Device& device, MemoryAllocator& allocator);
+        explicit Material(const Device& device);
         ~Material() = default;
 
         Material(const Material&) = delete;
@@ -38,24 +45,36 @@ namespace vkcommon {
 
         // static descriptor set layout management
         static void createDescriptorSetLayout(const Device& device);
+        // Takes set = 1 of the reflected pipeline shaders
+        static void createDescriptorSetLayout(const Device& device, const ShaderReflection& reflection);
         static void destroyDescriptorSetLayout();
-        static std::unique_ptr<DescriptorSetLayout>& getDescriptorSetLayout() { return s_descriptorSetLayout; }
+        static const DescriptorSetLayout* getDescriptorSetLayout() { return s_descriptorSetLayout; }
+
+        // Textures only, properties are fetched in-shader from the model's material buffer.
+        // Materials with the same textures get the same set from the cache.
+        // Not needed with bindless textures, which the shader finds through the properties.
+        void createDescriptorSet(DescriptorSetCache& setCache, const DescriptorSetLayout& layout);
+
+        const MaterialProperties& properties() const { return m_properties; }
 
-        void createDescriptorSets(DescriptorPool& pool, const DescriptorSetLayout& layout, uint32_t framesInFlight);
+        // constant_id of the texture switches in the model fragment shader
+        static constexpr uint32_t kHasDiffuseMapId = 0;
+        static constexpr uint32_t kHasSpecularMapId = 1;
+        static constexpr uint32_t kHasNormalMapId = 2;
 
-        void createPropertiesUBO(const int MAX_FRAMES_IN_FLIGHT);
-        void updateProperties(uint32_t currentImage);
+        // Which textures this material has, for a pipeline variant that skips
+        // the missing ones instead of sampling an unwritten descriptor
+        SpecializationConstants specialization() const;
 
         friend class Model;
         friend class Mesh;
 
     private:
-        // set it as static to be shared among all materials
-        static std::unique_ptr<DescriptorSetLayout> s_descriptorSetLayout;
-        std::vector<VkDescriptorSet> m_descriptorSets;
+        // set it as static to be shared among all materials, owned by the device's layout cache
+        static const DescriptorSetLayout* s_descriptorSetLayout;
+        VkDescriptorSet m_descriptorSet{ VK_NULL_HANDLE };
 
         MaterialProperties m_properties;
-        std::unique_ptr<UniformBuffer> m_ubo;
 
         std::shared_ptr<Texture> m_diffuseMap{ nullptr };
         std::shared_ptr<Texture> m_specularMap{ nullptr };
@@ -6,18 +6,16 @@
 
 #include <vulkan/vulkan.h>
 
+#include "resources/model/bounds.h"
+
 namespace vkcommon {
 
-    struct Vertex;
-    class VertexBuffer;
     class Material;
-    class Device;
-    class MemoryAllocator;
-    class CommandPool;
 
+    // A range of the owning Model's shared vertex and index buffers
     class Mesh {
     public:
-        Mesh(const Device& device, MemoryAllocator& allocator);
+        Mesh() = default;
         ~Mesh() = default;
 
         Mesh(const Mesh&) = delete;
@@ -26,22 +24,28 @@ namespace vkcommon {
         Mesh(Mesh&& other) noexcept;
         Mesh& operator=(Mesh&& other) noexcept;
 
-        void createVertexBuffer(
-            const std::vector<Vertex>& vertices, 
-            const std::vector<uint32_t>& indices, 
-            const CommandPool& cmdPool);
-
-        void draw(
-            VkCommandBuffer commandBuffer,
-            uint32_t currentFrame, 
-            VkPipelineLayout pipelineLayout);
+        // Expects the model's vertex and index buffers, material buffer and this
+        // mesh's material set to be bound. The material index is passed as
+        // firstInstance for the shader to fetch.
+        void draw(VkCommandBuffer commandBuffer);
+
+        uint32_t firstIndex() const { return m_firstIndex; }
+        uint32_t indexCount() const { return m_indexCount; }
+        int32_t vertexOffset() const { return m_vertexOffset; }
+        uint32_t materialIndex() const { return m_materialIndex; }
+        const BoundingBox& bounds() const { return m_bounds; }
+        const BoundingSphere& boundingSphere() const { return m_boundingSphere; }
     
         friend class Model;
 
     private:
-        std::unique_ptr<VertexBuffer> m_vertexBuffer;
         std::shared_ptr<Material> m_material;
+        uint32_t m_firstIndex{ 0 };
         uint32_t m_indexCount{ 0 };
+        int32_t m_vertexOffset{ 0 };
+        uint32_t m_materialIndex{ 0 };
+        BoundingBox m_bounds;
+        BoundingSphere m_boundingSphere;
     };
 
 } // namespace vkcommon
@@ -5,70 +5,515 @@
 #include "texture_lib.h"
 #include "core/device.h"
 #include "resources/buffers/vertex_buffer.h"
+#include "resources/buffers/indirect_buffer.h"
 #include "resources/memory/memory_allocator.h"
 #include "resources/descriptors/descriptor_set_layout.h"
-#include "resources/descriptors/descriptor_pool.h"
+#include "resources/descriptors/descriptor_set_layout_cache.h"
+#include "resources/descriptors/descriptor_set_cache.h"
 #include "resources/descriptors/descriptor_writer.h"
-#include "graphics/command_pool.h"
+#include "graphics/upload_context.h"
+#include "graphics/shader_reflection.h"
+#include "graphics/push_constants.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
 #include <stdexcept>
 
 namespace vkcommon {
+    const DescriptorSetLayout* Model::s_descriptorSetLayout{ nullptr };
+    const DescriptorSetLayout* Model::s_cullDescriptorSetLayout{ nullptr };
+
+    namespace {
+        // One per indirect command, matches DrawCullData in the culling shader (std430)
+        struct DrawCullData {
+            glm::vec4 sphere;       // Model-space center and radius
+            uint32_t groupIndex;    // Slot in the draw count buffer
+            uint32_t groupFirst;    // First command of the group in the culled buffer
+            uint32_t padding[2];
+        };
+
+        // Push constants of the culling shader. Only the model matrix of
+        // DrawConstants is read there, so the flag takes the normal matrix's place.
+        struct CullConstants {
+            glm::mat4 model;
+            uint32_t singleRange;   // Compact every survivor into group 0
+        };
+    }
+
+    struct Model::GeometryData {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+    };
 
     Model::Model(const Device& device, MemoryAllocator& allocator)
         : m_deviceRef(device)
-        , m_allocatorRef(allocator) {
+        , m_allocatorRef(allocator)
+        , m_geometry(std::make_unique<VertexBuffer>(device, allocator))
+        , m_materialBuffer(device, allocator)
+        , m_indirectBuffer(std::make_unique<IndirectBuffer>(device, allocator))
+        , m_cullDataBuffer(device, allocator)
+        , m_culledBuffer(std::make_unique<IndirectBuffer>(device, allocator))
+        , m_drawCountBuffer(device, allocator) {
     }
 
+    Model::~Model() = default;
+
     Model::Model(Model&& other) noexcept
         : m_deviceRef(other.m_deviceRef)
         , m_allocatorRef(other.m_allocatorRef)
-        , m_meshes(std::move(other.m_meshes)) {
+        , m_meshes(std::move(other.m_meshes))
+        , m_materials(std::move(other.m_materials))
+        , m_geometry(std::move(other.m_geometry))
+        , m_materialBuffer(std::move(other.m_materialBuffer))
+        , m_indirectBuffer(std::move(other.m_indirectBuffer))
+        , m_drawGroups(std::move(other.m_drawGroups))
+        , m_descriptorSet(other.m_descriptorSet)
+        , m_cullDataBuffer(std::move(other.m_cullDataBuffer))
+        , m_culledBuffer(std::move(other.m_culledBuffer))
+        , m_drawCountBuffer(std::move(other.m_drawCountBuffer))
+        , m_cullDescriptorSet(other.m_cullDescriptorSet)
+        , m_sphereCuller(std::move(other.m_sphereCuller))
+        , m_visibleMeshes(std::move(other.m_visibleMeshes))
+        , m_drawConstants(other.m_drawConstants)
+        , m_bindlessTextures(other.m_bindlessTextures) {
+        other.m_descriptorSet = VK_NULL_HANDLE;
+        other.m_cullDescriptorSet = VK_NULL_HANDLE;
     }
 
     Model& Model::operator=(Model&& other) noexcept {
         if (this != &other) {
             m_meshes = std::move(other.m_meshes);
+            m_materials = std::move(other.m_materials);
+            m_geometry = std::move(other.m_geometry);
+            m_materialBuffer = std::move(other.m_materialBuffer);
+            m_indirectBuffer = std::move(other.m_indirectBuffer);
+            m_drawGroups = std::move(other.m_drawGroups);
+            m_descriptorSet = other.m_descriptorSet;
+            other.m_descriptorSet = VK_NULL_HANDLE;
+            m_cullDataBuffer = std::move(other.m_cullDataBuffer);
+            m_culledBuffer = std::move(other.m_culledBuffer);
+            m_drawCountBuffer = std::move(other.m_drawCountBuffer);
+            m_cullDescriptorSet = other.m_cullDescriptorSet;
+            other.m_cullDescriptorSet = VK_NULL_HANDLE;
+            m_sphereCuller = std::move(other.m_sphereCuller);
+            m_visibleMeshes = std::move(other.m_visibleMeshes);
+            m_drawConstants = other.m_drawConstants;
+            m_bindlessTextures = other.m_bindlessTextures;
         }
         return *this;
     }
 
+    void Model::createDescriptorSetLayout(const Device& device) {
+        s_descriptorSetLayout = &device.descriptorSetLayoutCache().get({
+            // Material properties of the whole model, indexed by firstInstance
+            DescriptorSetLayoutCache::binding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
+        });
+
+        createCullDescriptorSetLayout(device);
+    }
+
+    void Model::createDescriptorSetLayout(const Device& device, const ShaderReflection& reflection) {
+        s_descriptorSetLayout = &device.descriptorSetLayoutCache().get(reflection.layoutBindings(2));
+
+        createCullDescriptorSetLayout(device);
+    }
+
+    void Model::createCullDescriptorSetLayout(const Device& device) {
+        s_cullDescriptorSetLayout = &device.descriptorSetLayoutCache().get({
+            DescriptorSetLayoutCache::binding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT),  // Bounds
+            DescriptorSetLayoutCache::binding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT),  // All commands
+            DescriptorSetLayoutCache::binding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT),  // Culled commands
+            DescriptorSetLayoutCache::binding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)   // Draw counts
+        });
+    }
+
+    void Model::destroyDescriptorSetLayout() {
+        // The layouts themselves go with the device's cache
+        s_descriptorSetLayout = nullptr;
+        s_cullDescriptorSetLayout = nullptr;
+    }
+
+    void Model::bindModelResources(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, VkShaderStageFlags pushConstantStages) {
+        // Bind once, each mesh draws its own range
+        m_geometry->bindVertexBuffer(commandBuffer, 0);
+        m_geometry->bindIndexBuffer(commandBuffer, VK_INDEX_TYPE_UINT32);
+
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipelineLayout,
+            2,  // Model Descriptors : 2
+            1,
+            &m_descriptorSet,
+            0,
+            nullptr
+        );
+
+        pushConstants(commandBuffer, pipelineLayout, pushConstantStages, m_drawConstants);
+    }
+
+    void Model::bindMaterial(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        const Material& material,
+        VkDescriptorSet& boundSet) {
+        if (m_bindlessTextures || material.m_descriptorSet == boundSet) {
+            return;
+        }
+
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipelineLayout,
+            1,  // Material Descriptors : 1
+            1,
+            &material.m_descriptorSet,
+            0,
+            nullptr
+        );
+        boundSet = material.m_descriptorSet;
+    }
+
+    void Model::setTransform(const glm::mat4& transform) {
+        m_drawConstants.model = transform;
+        m_drawConstants.normalMatrix = glm::transpose(glm::inverse(transform));
+    }
+
+    void Model::bindMaterialPipeline(
+        VkCommandBuffer commandBuffer,
+        const MaterialPipelineSelector& selectPipeline,
+        uint32_t materialIndex,
+        VkPipeline& boundPipeline) {
+        if (!selectPipeline) {
+            return;
+        }
+
+        // Same layout, so the bound descriptor sets stay valid across the switch
+        VkPipeline pipeline = selectPipeline(materialIndex);
+        if (pipeline != boundPipeline) {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            boundPipeline = pipeline;
+        }
+    }
+
     void Model::draw(
         VkCommandBuffer commandBuffer,
-        uint32_t currentFrame,
-        VkPipelineLayout pipelineLayout) {
-        for (const auto& mesh : m_meshes) {
-            mesh->draw(commandBuffer, currentFrame, pipelineLayout);
+        VkPipelineLayout pipelineLayout,
+        VkShaderStageFlags pushConstantStages,
+        const MaterialPipelineSelector& selectPipeline) {
+        drawRange(commandBuffer, pipelineLayout, pushConstantStages, 0, static_cast<uint32_t>(m_visibleMeshes.size()), selectPipeline);
+    }
+
+    void Model::drawRange(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        VkShaderStageFlags pushConstantStages,
+        uint32_t first,
+        uint32_t count,
+        const MaterialPipelineSelector& selectPipeline) {
+        if (!isLoaded()) {
+            return;
+        }
+
+        first = std::min(first, static_cast<uint32_t>(m_visibleMeshes.size()));
+        count = std::min(count, static_cast<uint32_t>(m_visibleMeshes.size()) - first);
+        if (count == 0) {
+            return;
+        }
+
+        bindModelResources(commandBuffer, pipelineLayout, pushConstantStages);
+
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
+        VkDescriptorSet boundMaterialSet = VK_NULL_HANDLE;
+        for (uint32_t i = first; i < first + count; i++) {
+            Mesh& mesh = *m_meshes[m_visibleMeshes[i]];
+            bindMaterialPipeline(commandBuffer, selectPipeline, mesh.materialIndex(), boundPipeline);
+            bindMaterial(commandBuffer, pipelineLayout, *mesh.m_material, boundMaterialSet);
+            mesh.draw(commandBuffer);
+        }
+    }
+
+    void Model::drawIndirect(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        VkShaderStageFlags pushConstantStages,
+        const MaterialPipelineSelector& selectPipeline) {
+        if (!isLoaded()) {
+            return;
+        }
+
+        // The material index travels in firstInstance
+        if (!m_deviceRef.enabledFeatures().drawIndirectFirstInstance) {
+            draw(commandBuffer, pipelineLayout, pushConstantStages, selectPipeline);
+            return;
+        }
+
+        bindModelResources(commandBuffer, pipelineLayout, pushConstantStages);
+
+        // Nothing changes between materials
+        if (drawsSingleRange(selectPipeline)) {
+            m_indirectBuffer->draw(commandBuffer, 0, m_indirectBuffer->commandCount());
+            return;
+        }
+
+        // Textures or pipelines change per material, so one indirect draw per material
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
+        VkDescriptorSet boundMaterialSet = VK_NULL_HANDLE;
+        for (const auto& group : m_drawGroups) {
+            bindMaterialPipeline(commandBuffer, selectPipeline, group.materialIndex, boundPipeline);
+
+            bindMaterial(commandBuffer, pipelineLayout, *m_materials[group.materialIndex], boundMaterialSet);
+
+            m_indirectBuffer->draw(commandBuffer, group.firstCommand, group.commandCount);
+        }
+    }
+
+    void Model::recordCulling(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout computeLayout,
+        const MaterialPipelineSelector& selectPipeline) {
+        if (!isLoaded()) {
+            return;
         }
+
+        // Last frame's indirect draws must be done with the counts and commands
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        vkCmdFillBuffer(commandBuffer, m_drawCountBuffer.handle(), 0, VK_WHOLE_SIZE, 0);
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            computeLayout,
+            1,  // Culling Descriptors : 1
+            1,
+            &m_cullDescriptorSet,
+            0,
+            nullptr
+        );
+        CullConstants constants{};
+        constants.model = m_drawConstants.model;
+        constants.singleRange = drawsSingleRange(selectPipeline) ? 1u : 0u;
+        pushConstants(commandBuffer, computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, constants);
+
+        uint32_t commandCount = m_indirectBuffer->commandCount();
+        vkCmdDispatch(commandBuffer, (commandCount + kCullGroupSize - 1) / kCullGroupSize, 1, 1);
+
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
     }
 
-    void Model::createDescriptor(DescriptorPool& pool, const DescriptorSetLayout& materialLayout, uint32_t framesInFlight)
+    void Model::drawCulled(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        VkShaderStageFlags pushConstantStages,
+        const MaterialPipelineSelector& selectPipeline) {
+        if (!isLoaded()) {
+            return;
+        }
+
+        if (!m_deviceRef.enabledFeatures().drawIndirectFirstInstance) {
+            draw(commandBuffer, pipelineLayout, pushConstantStages, selectPipeline);
+            return;
+        }
+
+        bindModelResources(commandBuffer, pipelineLayout, pushConstantStages);
+
+        // recordCulling compacted every survivor into the first count
+        if (drawsSingleRange(selectPipeline)) {
+            m_culledBuffer->drawCount(
+                commandBuffer,
+                m_drawCountBuffer.handle(),
+                0,
+                0,
+                m_culledBuffer->commandCount());
+            return;
+        }
+
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
+        VkDescriptorSet boundMaterialSet = VK_NULL_HANDLE;
+        for (uint32_t groupIndex = 0; groupIndex < m_drawGroups.size(); groupIndex++) {
+            const DrawGroup& group = m_drawGroups[groupIndex];
+            bindMaterialPipeline(commandBuffer, selectPipeline, group.materialIndex, boundPipeline);
+
+            bindMaterial(commandBuffer, pipelineLayout, *m_materials[group.materialIndex], boundMaterialSet);
+
+            m_culledBuffer->drawCount(
+                commandBuffer,
+                m_drawCountBuffer.handle(),
+                groupIndex * sizeof(uint32_t),
+                group.firstCommand,
+                group.commandCount);
+        }
+    }
+
+    bool Model::drawsSingleRange(const MaterialPipelineSelector& selectPipeline) const {
+        return m_bindlessTextures && !selectPipeline;
+    }
+
+    void Model::cull(const Frustum& frustum) {
+        m_sphereCuller.cull(frustum, m_visibleMeshes);
+    }
+
+    void Model::createDescriptor(DescriptorSetCache& setCache, const DescriptorSetLayout* materialLayout)
     {
-        for (const auto& mesh : m_meshes) {
-            if (mesh->m_material) {
-                mesh->m_material->createPropertiesUBO(framesInFlight);
-                mesh->m_material->createDescriptorSets(pool, materialLayout, framesInFlight);
+        if (!m_bindlessTextures) {
+            if (materialLayout == nullptr) {
+                throw std::runtime_error("Failed to create material descriptors: no material layout");
+            }
+            for (const auto& material : m_materials) {
+                if (material) {
+                    material->createDescriptorSet(setCache, *materialLayout);
+                }
             }
         }
+
+        if (!isLoaded()) {
+            return;
+        }
+
+        DescriptorWriter writer;
+        writer.writeBuffer(
+            0,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            m_materialBuffer.handle(),
+            m_materialBuffer.size());
+        m_descriptorSet = setCache.get(*s_descriptorSetLayout, writer);
+
+        DescriptorWriter cullWriter;
+        cullWriter.writeBuffer(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            m_cullDataBuffer.handle(), m_cullDataBuffer.size());
+        cullWriter.writeBuffer(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            m_indirectBuffer->handle(), IndirectBuffer::kStride * m_indirectBuffer->commandCount());
+        cullWriter.writeBuffer(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            m_culledBuffer->handle(), IndirectBuffer::kStride * m_culledBuffer->commandCount());
+        cullWriter.writeBuffer(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            m_drawCountBuffer.handle(), m_drawCountBuffer.size());
+        m_cullDescriptorSet = setCache.get(*s_cullDescriptorSetLayout, cullWriter);
     }
 
-    void Model::updateProperties(uint32_t currentFrame)
-    {
+    void Model::forgetDescriptors(DescriptorSetCache& setCache) const {
+        if (!isLoaded()) {
+            return;
+        }
+
+        setCache.forget(m_materialBuffer.handle());
+        setCache.forget(m_cullDataBuffer.handle());
+        setCache.forget(m_indirectBuffer->handle());
+        setCache.forget(m_culledBuffer->handle());
+        setCache.forget(m_drawCountBuffer.handle());
+    }
+
+    void Model::buildDrawCommands(UploadContext& uploadContext) {
+        // Order draws by material so each material is one contiguous indirect range
+        std::vector<uint32_t> order(m_meshes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return m_meshes[a]->m_materialIndex < m_meshes[b]->m_materialIndex;
+        });
+
+        std::vector<VkDrawIndexedIndirectCommand> commands;
+        std::vector<DrawCullData> cullData;
+        commands.reserve(order.size());
+        cullData.reserve(order.size());
+        m_drawGroups.clear();
+
+        for (uint32_t meshIndex : order) {
+            const Mesh& mesh = *m_meshes[meshIndex];
+
+            if (m_drawGroups.empty() || m_drawGroups.back().materialIndex != mesh.m_materialIndex) {
+                m_drawGroups.push_back({ mesh.m_materialIndex, static_cast<uint32_t>(commands.size()), 0 });
+            }
+            m_drawGroups.back().commandCount++;
+
+            VkDrawIndexedIndirectCommand command{};
+            command.indexCount = mesh.m_indexCount;
+            command.instanceCount = 1;
+            command.firstIndex = mesh.m_firstIndex;
+            command.vertexOffset = mesh.m_vertexOffset;
+            command.firstInstance = mesh.m_materialIndex;
+            commands.push_back(command);
+
+            DrawCullData data{};
+            data.sphere = glm::vec4(mesh.m_boundingSphere.center, mesh.m_boundingSphere.radius);
+            data.groupIndex = static_cast<uint32_t>(m_drawGroups.size()) - 1;
+            data.groupFirst = m_drawGroups.back().firstCommand;
+            cullData.push_back(data);
+        }
+
+        // The culling shader reads the full list and writes the compacted one
+        m_indirectBuffer->create(commands, uploadContext, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        m_culledBuffer->create(commands, uploadContext, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+        VkDeviceSize cullDataSize = sizeof(DrawCullData) * cullData.size();
+        m_cullDataBuffer.create(
+            cullDataSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+        uploadContext.uploadBuffer(m_cullDataBuffer, cullData.data(), cullDataSize);
+
+        // Cleared by every culling pass, so no upload
+        m_drawCountBuffer.create(
+            sizeof(uint32_t) * m_drawGroups.size(),
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+
+        m_sphereCuller.clear();
+        m_sphereCuller.reserve(m_meshes.size());
         for (const auto& mesh : m_meshes) {
-            if (mesh->m_material) {
-                mesh->m_material->updateProperties(currentFrame);
+            m_sphereCuller.add(mesh->m_boundingSphere);
+        }
+
+        m_visibleMeshes.resize(m_meshes.size());
+        std::iota(m_visibleMeshes.begin(), m_visibleMeshes.end(), 0);
+
+        // Materials the scene declares but no mesh uses keep default properties
+        std::vector<MaterialProperties> properties(m_materials.size(), MaterialProperties{});
+        for (size_t i = 0; i < m_materials.size(); i++) {
+            if (m_materials[i]) {
+                properties[i] = m_materials[i]->m_properties;
             }
         }
+
+        VkDeviceSize bufferSize = sizeof(MaterialProperties) * properties.size();
+        m_materialBuffer.create(
+            bufferSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+        uploadContext.uploadBuffer(m_materialBuffer, properties.data(), bufferSize);
     }
 
     void Model::loadFromFile(
         const std::filesystem::path& path,
         TextureLibrary& textureLib,
-        const CommandPool& cmdPool) {
+        UploadContext& uploadContext) {
 
         // Initialize Assimp importer with common post-processing steps
         Assimp::Importer importer;
@@ -82,26 +527,41 @@ namespace vkcommon {
             throw std::runtime_error("Failed to load model: " + path.string() + "\n" + importer.GetErrorString());
         }
 
+        m_materials.resize(scene->mNumMaterials);
+        m_bindlessTextures = textureLib.bindlessTable() != nullptr;
+
         // Start recursive loading from root node
-        loadNode(scene->mRootNode, scene, textureLib, cmdPool, path.parent_path());
+        GeometryData geometry;
+        loadNode(scene->mRootNode, scene, textureLib, uploadContext, path.parent_path(), geometry);
+
+        if (geometry.indices.empty()) {
+            return;
+        }
+
+        // Pack all meshes into the shared buffers
+        m_geometry->createVertexBuffer(geometry.vertices, uploadContext);
+        m_geometry->createIndexBuffer(geometry.indices, uploadContext);
+
+        buildDrawCommands(uploadContext);
     }
 
     void Model::loadNode(
         const aiNode* node,
         const aiScene* scene,
         TextureLibrary& textureLib,
-        const CommandPool& cmdPool,
-        const std::filesystem::path& modelPath) {
+        UploadContext& uploadContext,
+        const std::filesystem::path& modelPath,
+        GeometryData& geometry) {
 
         // Process all meshes in the current node
         for (unsigned int i = 0; i < node->mNumMeshes; i++) {
             aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            processMesh(mesh, scene, textureLib, cmdPool, modelPath);
+            processMesh(mesh, scene, textureLib, uploadContext, modelPath, geometry);
         }
 
         // Process all child nodes
         for (unsigned int i = 0; i < node->mNumChildren; i++) {
-            loadNode(node->mChildren[i], scene, textureLib, cmdPool, modelPath);
+            loadNode(node->mChildren[i], scene, textureLib, uploadContext, modelPath, geometry);
         }
     }
 
@@ -109,11 +569,21 @@ namespace vkcommon {
         const aiMesh* mesh,
         const aiScene* scene,
         TextureLibrary& textureLib,
-        const CommandPool& cmdPool,
-        const std::filesystem::path& modelPath) {
+        UploadContext& uploadContext,
+        const std::filesystem::path& modelPath,
+        GeometryData& geometry) {
 
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
+        std::vector<Vertex>& vertices = geometry.vertices;
+        std::vector<uint32_t>& indices = geometry.indices;
+
+        // Indices stay relative to the mesh, vertexOffset rebases them at draw time
+        auto newMesh = std::make_shared<Mesh>();
+        newMesh->m_firstIndex = static_cast<uint32_t>(indices.size());
+        newMesh->m_vertexOffset = static_cast<int32_t>(vertices.size());
+
+        BoundingBox& bounds = newMesh->m_bounds;
+        bounds.min = glm::vec3(std::numeric_limits<float>::max());
+        bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
 
         // Process vertices
         for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
@@ -157,9 +627,24 @@ namespace vkcommon {
                 };
             }
 
+            bounds.min = glm::min(bounds.min, vertex.pos);
+            bounds.max = glm::max(bounds.max, vertex.pos);
+
             vertices.push_back(vertex);
         }
 
+        if (mesh->mNumVertices == 0) {
+            bounds = BoundingBox{};
+        }
+
+        // Sphere around the box center, tighter than the box's half diagonal
+        BoundingSphere& sphere = newMesh->m_boundingSphere;
+        sphere.center = bounds.center();
+        sphere.radius = 0.0f;
+        for (size_t i = newMesh->m_vertexOffset; i < vertices.size(); i++) {
+            sphere.radius = std::max(sphere.radius, glm::distance(sphere.center, vertices[i].pos));
+        }
+
         // Process indices
         for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
             aiFace face = mesh->mFaces[i];
@@ -168,12 +653,14 @@ namespace vkcommon {
             }
         }
 
-        // Create mesh
-        auto newMesh = std::make_shared<Mesh>(m_deviceRef, m_allocatorRef);
-        newMesh->createVertexBuffer(vertices, indices, cmdPool);
+        newMesh->m_indexCount = static_cast<uint32_t>(indices.size()) - newMesh->m_firstIndex;
+
+        // Process material, once per scene material
+        newMesh->m_materialIndex = mesh->mMaterialIndex;
+        std::shared_ptr<Material>& vkMaterial = m_materials[mesh->mMaterialIndex];
 
-        // Process material
-        if (mesh->mMaterialIndex >= 0) {
+        if (!vkMaterial) {
+            vkMaterial = std::make_shared<Material>(m_deviceRef);
             aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
 
             // Get material properties
@@ -181,30 +668,31 @@ namespace vkcommon {
             float value;
 
             if (material->Get(AI_MATKEY_COLOR_AMBIENT, color) == AI_SUCCESS) {
-                newMesh->m_material->m_properties.ambientColor = { color.r, color.g, color.b, 1.0f };
+                vkMaterial->m_properties.ambientColor = { color.r, color.g, color.b, 1.0f };
             }
             if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS) {
-                newMesh->m_material->m_properties.diffuseColor = { color.r, color.g, color.b, 1.0f };
+                vkMaterial->m_properties.diffuseColor = { color.r, color.g, color.b, 1.0f };
             }
             if (material->Get(AI_MATKEY_COLOR_SPECULAR, color) == AI_SUCCESS) {
-                newMesh->m_material->m_properties.specularColor = { color.r, color.g, color.b, 1.0f };
+                vkMaterial->m_properties.specularColor = { color.r, color.g, color.b, 1.0f };
             }
             if (material->Get(AI_MATKEY_COLOR_EMISSIVE, color) == AI_SUCCESS) {
-                newMesh->m_material->m_properties.emissiveColor = { color.r, color.g, color.b, 1.0f };
+                vkMaterial->m_properties.emissiveColor = { color.r, color.g, color.b, 1.0f };
             }
             if (material->Get(AI_MATKEY_SHININESS, value) == AI_SUCCESS) {
-                newMesh->m_material->m_properties.shininess = value;
+                vkMaterial->m_properties.shininess = value;
             }
             if (material->Get(AI_MATKEY_OPACITY, value) == AI_SUCCESS) {
-                newMesh->m_material->m_properties.opacity = value;
+                vkMaterial->m_properties.opacity = value;
             }
             if (material->Get(AI_MATKEY_REFRACTI, value) == AI_SUCCESS) {
-                newMesh->m_material->m_properties.refractiveIndex = value;
+                vkMaterial->m_properties.refractiveIndex = value;
             }
 
             // Load textures
-            loadMaterialTextures(material, textureLib, cmdPool, modelPath, newMesh->m_material);
+            loadMaterialTextures(material, textureLib, uploadContext, modelPath, vkMaterial);
         }
+        newMesh->m_material = vkMaterial;
 
         m_meshes.push_back(newMesh);
     }
@@ -212,7 +700,7 @@ namespace vkcommon {
     void Model::loadMaterialTextures(
         const aiMaterial* material,
         TextureLibrary& textureLib,
-        const CommandPool& cmdPool,
+        UploadContext& uploadContext,
         const std::filesystem::path& modelPath,
         std::shared_ptr<Material> vkMaterial) {
 
@@ -221,21 +709,26 @@ namespace vkcommon {
         // Diffuse texture
         if (material->GetTexture(aiTextureType_DIFFUSE, 0, &texturePath) == AI_SUCCESS) {
             auto fullPath = modelPath / texturePath.C_Str();
-            vkMaterial->m_diffuseMap = textureLib.getOrLoadTexture(fullPath, cmdPool);
+            vkMaterial->m_diffuseMap = textureLib.getOrLoadTexture(fullPath, uploadContext);
         }
 
         // Specular texture
         if (material->GetTexture(aiTextureType_SPECULAR, 0, &texturePath) == AI_SUCCESS) {
             auto fullPath = modelPath / texturePath.C_Str();
-            vkMaterial->m_specularMap = textureLib.getOrLoadTexture(fullPath, cmdPool);
+            vkMaterial->m_specularMap = textureLib.getOrLoadTexture(fullPath, uploadContext);
         }
 
         // Normal texture 
         if (material->GetTexture(aiTextureType_NORMALS, 0, &texturePath) == AI_SUCCESS ||
             material->GetTexture(aiTextureType_HEIGHT, 0, &texturePath) == AI_SUCCESS) {
             auto fullPath = modelPath / texturePath.C_Str();
-            vkMaterial->m_normalMap = textureLib.getOrLoadTexture(fullPath, cmdPool);
+            vkMaterial->m_normalMap = textureLib.getOrLoadTexture(fullPath, uploadContext);
         }
+
+        // Slots for the bindless shader, kNoTexture without a table
+        vkMaterial->m_properties.diffuseTexture = textureLib.bindlessIndex(vkMaterial->m_diffuseMap.get());
+        vkMaterial->m_properties.specularTexture = textureLib.bindlessIndex(vkMaterial->m_specularMap.get());
+        vkMaterial->m_properties.normalTexture = textureLib.bindlessIndex(vkMaterial->m_normalMap.get());
     }
 
 } // namespace vkcommon
\ No newline at end of file
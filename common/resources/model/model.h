@@ -4,7 +4,12 @@
 #include <memory>
 #include <vector>
 #include <filesystem>
+#include <functional>
 #include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "resources/buffers/buffer.h"
+#include "resources/model/sphere_culler.h"
 
 class aiNode;
 struct aiScene;
@@ -14,18 +19,33 @@ class aiMaterial;
 namespace vkcommon {
     class Device;
     class MemoryAllocator;
-    class CommandPool;
+    class UploadContext;
+    class VertexBuffer;
+    class IndirectBuffer;
     class Mesh;
     class Material;
     class TextureLibrary;
     class DescriptorSetLayout;
-    class DescriptorPool;
+    class ShaderReflection;
+    class DescriptorSetCache;
     class DescriptorWriter;
+    class Frustum;
+
+    // Pipeline to draw a material with, e.g. a variant specialized on its
+    // textures. Must share the layout the draw is given.
+    using MaterialPipelineSelector = std::function<VkPipeline(uint32_t materialIndex)>;
 
     class Model {
     public:
+        // Pushed once per model, matches the push_constant block of the model
+        // and culling shaders. 128 bytes, the guaranteed minimum.
+        struct DrawConstants {
+            glm::mat4 model;
+            glm::mat4 normalMatrix;     // inverse transpose of model, precomputed on the CPU
+        };
+
         Model(const Device& device, MemoryAllocator& allocator);
-        ~Model() = default;
+        ~Model();
 
         Model(const Model&) = delete;
         Model& operator=(const Model&) = delete;
@@ -36,49 +56,185 @@ namespace vkcommon {
         void loadFromFile(
             const std::filesystem::path& path,
             TextureLibrary& textureLib,
-            const CommandPool& cmdPool
+            UploadContext& uploadContext
         );
 
+        // static descriptor set layout of the per-model set (set = 2)
+        static void createDescriptorSetLayout(const Device& device);
+        // Takes set = 2 of the reflected pipeline shaders, the culling layout stays fixed
+        static void createDescriptorSetLayout(const Device& device, const ShaderReflection& reflection);
+        static void destroyDescriptorSetLayout();
+        static const DescriptorSetLayout* getDescriptorSetLayout() { return s_descriptorSetLayout; }
+        // Layout of the culling set (set = 1 of the culling pipeline), created alongside
+        static const DescriptorSetLayout* getCullDescriptorSetLayout() { return s_cullDescriptorSetLayout; }
+
+        // Must match local_size_x of the culling shader
+        static constexpr uint32_t kCullGroupSize = 64;
+
+        // Gets the material sets, the model set holding the material buffer
+        // and the culling set; materials with the same textures share a set.
+        // materialLayout may be null with bindless textures, which need no material sets.
         void createDescriptor(
-            DescriptorPool& pool,
-            const DescriptorSetLayout& materialLayout,
-            uint32_t framesInFlight);
-
-        void updateProperties(uint32_t currentFrame);
-        
+            DescriptorSetCache& setCache,
+            const DescriptorSetLayout* materialLayout);
+        // Drops the sets naming the model's buffers from setCache, before the
+        // model is destroyed. Material sets name library textures and stay.
+        void forgetDescriptors(DescriptorSetCache& setCache) const;
+
+        // One vkCmdDrawIndexed per mesh. With selectPipeline, binds the
+        // material's pipeline whenever it differs from the last one bound.
+        // pushConstantStages are the stages of the layout's push constant
+        // range, e.g. GraphicsPipeline::pushConstantStages().
         void draw(
             VkCommandBuffer commandBuffer,
-            uint32_t currentFrame,
-            VkPipelineLayout pipelineLayout);
+            VkPipelineLayout pipelineLayout,
+            VkShaderStageFlags pushConstantStages,
+            const MaterialPipelineSelector& selectPipeline = {});
+
+        // draw() over visibleMeshes()[first, first + count), so one model can
+        // be split across secondary command buffers recorded in parallel.
+        // Binds the model and material sets itself, like draw().
+        void drawRange(
+            VkCommandBuffer commandBuffer,
+            VkPipelineLayout pipelineLayout,
+            VkShaderStageFlags pushConstantStages,
+            uint32_t first,
+            uint32_t count,
+            const MaterialPipelineSelector& selectPipeline = {});
+
+        // One vkCmdDrawIndexedIndirect per material, or a single one for all
+        // materials with bindless textures and no selectPipeline. Falls back to
+        // draw() without drawIndirectFirstInstance
+        void drawIndirect(
+            VkCommandBuffer commandBuffer,
+            VkPipelineLayout pipelineLayout,
+            VkShaderStageFlags pushConstantStages,
+            const MaterialPipelineSelector& selectPipeline = {});
+
+        // GPU culling: tests every draw against the frustum of the global UBO and
+        // compacts the survivors of each material into the culled indirect buffer,
+        // or of all materials into one range when drawCulled will issue a single
+        // draw. selectPipeline must be the one later passed to drawCulled.
+        // Expects the culling pipeline and its global set (set = 0) to be bound,
+        // and must be recorded outside a render pass.
+        void recordCulling(
+            VkCommandBuffer commandBuffer,
+            VkPipelineLayout computeLayout,
+            const MaterialPipelineSelector& selectPipeline = {});
+
+        // Draws the output of recordCulling, requires drawIndirectCount. One
+        // vkCmdDrawIndexedIndirectCount per material, or a single one over every
+        // command with bindless textures and no selectPipeline.
+        void drawCulled(
+            VkCommandBuffer commandBuffer,
+            VkPipelineLayout pipelineLayout,
+            VkShaderStageFlags pushConstantStages,
+            const MaterialPipelineSelector& selectPipeline = {});
+
+        // Model to world, pushed by the draws and recordCulling
+        void setTransform(const glm::mat4& transform);
+        const glm::mat4& transform() const { return m_drawConstants.model; }
+
+        // CPU version of the culling shader through SphereCuller, frustum planes
+        // must be in model space. Selects the meshes draw() issues until the next call.
+        void cull(const Frustum& frustum);
 
         const std::vector<std::shared_ptr<Mesh>>& getMeshes() const { return m_meshes; }
+        const std::vector<uint32_t>& visibleMeshes() const { return m_visibleMeshes; }
+        const std::vector<std::shared_ptr<Material>>& getMaterials() const { return m_materials; }
+        const VertexBuffer& geometry() const { return *m_geometry; }
+        const IndirectBuffer& indirectCommands() const { return *m_indirectBuffer; }
         bool isLoaded() const { return !m_meshes.empty(); }
+        // Loaded with a TextureLibrary that had bindless enabled: materials
+        // carry texture slots and set 1 is the library's table, bound by the caller
+        bool usesBindlessTextures() const { return m_bindlessTextures; }
 
     private:
+        static void createCullDescriptorSetLayout(const Device& device);
+        // Skips the bind when the material's set is already bound, which
+        // includes other materials sharing the set through the cache, and
+        // with bindless textures
+        void bindMaterial(
+            VkCommandBuffer commandBuffer,
+            VkPipelineLayout pipelineLayout,
+            const Material& material,
+            VkDescriptorSet& boundSet);
+        static void bindMaterialPipeline(
+            VkCommandBuffer commandBuffer,
+            const MaterialPipelineSelector& selectPipeline,
+            uint32_t materialIndex,
+            VkPipeline& boundPipeline);
+
+        // Vertices and indices of every mesh, gathered while walking the scene
+        struct GeometryData;
+
+        // Consecutive indirect commands sharing a material
+        struct DrawGroup {
+            uint32_t materialIndex;
+            uint32_t firstCommand;
+            uint32_t commandCount;
+        };
+
+        // set it as static to be shared among all models, owned by the device's layout cache
+        static const DescriptorSetLayout* s_descriptorSetLayout;
+        static const DescriptorSetLayout* s_cullDescriptorSetLayout;
+
         const Device& m_deviceRef;
         MemoryAllocator& m_allocatorRef;
         std::vector<std::shared_ptr<Mesh>> m_meshes;
+        // Indexed by the scene's material index, shared by the meshes using it
+        std::vector<std::shared_ptr<Material>> m_materials;
+        // One vertex and one index buffer shared by all meshes
+        std::unique_ptr<VertexBuffer> m_geometry;
+
+        // MaterialProperties per material, read in-shader by material index
+        Buffer m_materialBuffer;
+        std::unique_ptr<IndirectBuffer> m_indirectBuffer;
+        std::vector<DrawGroup> m_drawGroups;
+        VkDescriptorSet m_descriptorSet{ VK_NULL_HANDLE };
+
+        // GPU culling: bounds per command, compacted commands and one draw
+        // count per draw group
+        Buffer m_cullDataBuffer;
+        std::unique_ptr<IndirectBuffer> m_culledBuffer;
+        Buffer m_drawCountBuffer;
+        VkDescriptorSet m_cullDescriptorSet{ VK_NULL_HANDLE };
+
+        // Mesh bounding spheres in mesh order for cull()
+        SphereCuller m_sphereCuller;
+        // Meshes drawn by draw(), every mesh until cull() is called
+        std::vector<uint32_t> m_visibleMeshes;
+
+        DrawConstants m_drawConstants{ glm::mat4(1.0f), glm::mat4(1.0f) };
+        bool m_bindlessTextures{ false };
+
+        void buildDrawCommands(UploadContext& uploadContext);
+        // Nothing to rebind between materials, so all commands form one range
+        bool drawsSingleRange(const MaterialPipelineSelector& selectPipeline) const;
+        void bindModelResources(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, VkShaderStageFlags pushConstantStages);
 
         void loadNode(
             const aiNode* node,
             const aiScene* scene,
             TextureLibrary& textureLib,
-            const CommandPool& cmdPool,
-            const std::filesystem::path& modelPath
+            UploadContext& uploadContext,
+            const std::filesystem::path& modelPath,
+            GeometryData& geometry
         );
 
         void processMesh(
             const aiMesh* mesh,
             const aiScene* scene,
             TextureLibrary& textureLib,
-            const CommandPool& cmdPool,
-            const std::filesystem::path& modelPath
+            UploadContext& uploadContext,
+            const std::filesystem::path& modelPath,
+            GeometryData& geometry
         );
 
         void loadMaterialTextures(
             const aiMaterial* material,
             TextureLibrary& textureLib,
-            const CommandPool& cmdPool,
+            UploadContext& uploadContext,
             const std::filesystem::path& modelPath,
             std::shared_ptr<Material> vkMaterial
         );
@@ -0,0 +1,238 @@
+#include "sphere_culler.h"
+
+#include "frustum.h"
+
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VKCOMMON_CULL_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 code is compiled for that target only, the rest of the build keeps its baseline
+#if defined(VKCOMMON_CULL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define VKCOMMON_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VKCOMMON_TARGET_AVX2
+#endif
+
+namespace vkcommon {
+
+    namespace {
+#ifdef VKCOMMON_CULL_X86
+        bool cpuHasAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            bool avx = (info[2] & (1 << 28)) != 0;
+            // The OS must save the YMM registers
+            if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return false;
+#endif
+        }
+#endif
+
+        // Appends the set bits of mask, offset by base
+        inline uint32_t writeMask(uint32_t mask, uint32_t base, uint32_t* out) {
+            uint32_t count = 0;
+            while (mask != 0) {
+                out[count++] = base + static_cast<uint32_t>(std::countr_zero(mask));
+                mask &= mask - 1;
+            }
+            return count;
+        }
+    }
+
+    void SphereCuller::clear() {
+        m_x.clear();
+        m_y.clear();
+        m_z.clear();
+        m_radius.clear();
+    }
+
+    void SphereCuller::reserve(size_t count) {
+        m_x.reserve(count);
+        m_y.reserve(count);
+        m_z.reserve(count);
+        m_radius.reserve(count);
+    }
+
+    uint32_t SphereCuller::add(const BoundingSphere& sphere) {
+        uint32_t index = static_cast<uint32_t>(m_radius.size());
+        m_x.push_back(sphere.center.x);
+        m_y.push_back(sphere.center.y);
+        m_z.push_back(sphere.center.z);
+        m_radius.push_back(sphere.radius);
+        return index;
+    }
+
+    SphereCuller::Path SphereCuller::bestPath() {
+        static const Path path = isSupported(Path::AVX2) ? Path::AVX2
+            : isSupported(Path::SSE) ? Path::SSE
+            : Path::Scalar;
+        return path;
+    }
+
+    bool SphereCuller::isSupported(Path path) {
+        switch (path) {
+#ifdef VKCOMMON_CULL_X86
+        case Path::AVX2: {
+            static const bool hasAVX2 = cpuHasAVX2();
+            return hasAVX2;
+        }
+        // SSE2 is part of every x86-64 CPU
+        case Path::SSE:
+            return true;
+#endif
+        case Path::Scalar:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    const char* SphereCuller::pathName(Path path) {
+        switch (path) {
+        case Path::AVX2:
+            return "AVX2";
+        case Path::SSE:
+            return "SSE";
+        default:
+            return "scalar";
+        }
+    }
+
+    void SphereCuller::cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+        cull(frustum, visible, bestPath());
+    }
+
+    void SphereCuller::cull(const Frustum& frustum, std::vector<uint32_t>& visible, Path path) const {
+        if (!isSupported(path)) {
+            path = Path::Scalar;
+        }
+
+        // Sized for the worst case, then trimmed to what survived
+        visible.resize(size());
+        uint32_t count = 0;
+
+        switch (path) {
+        case Path::AVX2:
+            count = cullAVX2(frustum, visible.data());
+            break;
+        case Path::SSE:
+            count = cullSSE(frustum, visible.data());
+            break;
+        default:
+            count = cullScalar(frustum, 0, static_cast<uint32_t>(size()), visible.data());
+            break;
+        }
+
+        visible.resize(count);
+    }
+
+    uint32_t SphereCuller::cullScalar(const Frustum& frustum, uint32_t first, uint32_t last, uint32_t* out) const {
+        const auto& planes = frustum.planes();
+        uint32_t count = 0;
+
+        for (uint32_t i = first; i < last; i++) {
+            bool inside = true;
+            for (const auto& plane : planes) {
+                // Same association as the SIMD paths so all of them agree exactly
+                float distance = (plane.x * m_x[i] + plane.y * m_y[i]) + (plane.z * m_z[i] + plane.w);
+                if (distance < -m_radius[i]) {
+                    inside = false;
+                    break;
+                }
+            }
+            if (inside) {
+                out[count++] = i;
+            }
+        }
+
+        return count;
+    }
+
+#ifdef VKCOMMON_CULL_X86
+    uint32_t SphereCuller::cullSSE(const Frustum& frustum, uint32_t* out) const {
+        const auto& planes = frustum.planes();
+        uint32_t total = static_cast<uint32_t>(size());
+        uint32_t simdEnd = total - total % 4;
+        uint32_t count = 0;
+
+        for (uint32_t i = 0; i < simdEnd; i += 4) {
+            __m128 x = _mm_loadu_ps(&m_x[i]);
+            __m128 y = _mm_loadu_ps(&m_y[i]);
+            __m128 z = _mm_loadu_ps(&m_z[i]);
+            __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&m_radius[i]));
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+            for (const auto& plane : planes) {
+                __m128 distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+                    _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+
+                if (_mm_movemask_ps(inside) == 0) {
+                    break;
+                }
+            }
+
+            count += writeMask(static_cast<uint32_t>(_mm_movemask_ps(inside)), i, out + count);
+        }
+
+        return count + cullScalar(frustum, simdEnd, total, out + count);
+    }
+
+    VKCOMMON_TARGET_AVX2
+    uint32_t SphereCuller::cullAVX2(const Frustum& frustum, uint32_t* out) const {
+        const auto& planes = frustum.planes();
+        uint32_t total = static_cast<uint32_t>(size());
+        uint32_t simdEnd = total - total % 8;
+        uint32_t count = 0;
+
+        for (uint32_t i = 0; i < simdEnd; i += 8) {
+            __m256 x = _mm256_loadu_ps(&m_x[i]);
+            __m256 y = _mm256_loadu_ps(&m_y[i]);
+            __m256 z = _mm256_loadu_ps(&m_z[i]);
+            __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&m_radius[i]));
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+            for (const auto& plane : planes) {
+                __m256 distance = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane.x)), _mm256_mul_ps(y, _mm256_set1_ps(plane.y))),
+                    _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+
+                if (_mm256_movemask_ps(inside) == 0) {
+                    break;
+                }
+            }
+
+            count += writeMask(static_cast<uint32_t>(_mm256_movemask_ps(inside)), i, out + count);
+        }
+
+        return count + cullScalar(frustum, simdEnd, total, out + count);
+    }
+#else
+    uint32_t SphereCuller::cullSSE(const Frustum& frustum, uint32_t* out) const {
+        return cullScalar(frustum, 0, static_cast<uint32_t>(size()), out);
+    }
+
+    uint32_t SphereCuller::cullAVX2(const Frustum& frustum, uint32_t* out) const {
+        return cullScalar(frustum, 0, static_cast<uint32_t>(size()), out);
+    }
+#endif
+
+} // namespace vkcommon
@@ -0,0 +1,59 @@
+#ifndef SPHERE_CULLER_H
+#define SPHERE_CULLER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "resources/model/bounds.h"
+
+namespace vkcommon {
+
+    class Frustum;
+
+    // Frustum culling of many bounding spheres on the CPU. Spheres are kept
+    // as separate x / y / z / radius arrays so 4 (SSE) or 8 (AVX2) of them are
+    // tested against a plane per instruction. The SIMD path is picked at
+    // runtime from what the CPU supports; the scalar path is the reference.
+    class SphereCuller {
+    public:
+        enum class Path {
+            Scalar,
+            SSE,
+            AVX2
+        };
+
+        SphereCuller() = default;
+
+        void clear();
+        void reserve(size_t count);
+
+        // Returns the index reported by cull()
+        uint32_t add(const BoundingSphere& sphere);
+
+        size_t size() const { return m_radius.size(); }
+
+        // Replaces visible with the indices of the spheres intersecting the
+        // frustum, in increasing order
+        void cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+        void cull(const Frustum& frustum, std::vector<uint32_t>& visible, Path path) const;
+
+        // Fastest path supported by this build and CPU
+        static Path bestPath();
+        static bool isSupported(Path path);
+        static const char* pathName(Path path);
+
+    private:
+        // Each writes the visible indices of [first, last) to out and returns the count
+        uint32_t cullScalar(const Frustum& frustum, uint32_t first, uint32_t last, uint32_t* out) const;
+        uint32_t cullSSE(const Frustum& frustum, uint32_t* out) const;
+        uint32_t cullAVX2(const Frustum& frustum, uint32_t* out) const;
+
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_z;
+        std::vector<float> m_radius;
+    };
+
+} // namespace vkcommon
+
+#endif // SPHERE_CULLER_H
@@ -3,7 +3,8 @@
 #include "core/device.h"
 #include "resources/memory/memory_allocator.h"
 #include "resources/images/texture.h"
-#include "graphics/command_pool.h"
+#include "resources/descriptors/bindless_texture_table.h"
+#include "graphics/upload_context.h"
 
 namespace vkcommon {
 
@@ -11,7 +12,9 @@ namespace vkcommon {
         : m_deviceRef(device), m_allocatorRef(allocator) {
     }
 
-    std::shared_ptr<Texture> TextureLibrary::getOrLoadTexture(const std::filesystem::path& path, const CommandPool& cmdPool)
+    TextureLibrary::~TextureLibrary() = default;
+
+    std::shared_ptr<Texture> TextureLibrary::getOrLoadTexture(const std::filesystem::path& path, UploadContext& uploadContext)
     {
         auto it = m_texturesMap.find(path);
         if (it != m_texturesMap.end()) {
@@ -19,11 +22,34 @@ namespace vkcommon {
         }
 
         auto texture = std::make_shared<Texture>(m_deviceRef, m_allocatorRef);
-        texture->loadFromFile(path, cmdPool);
+        texture->loadFromFile(path, uploadContext);
         texture->createSampler();
 
         m_texturesMap[path] = texture;
+        if (m_bindlessTable) {
+            m_bindlessTable->add(*texture);
+        }
         return texture;
     }
 
+    void TextureLibrary::enableBindless(uint32_t capacity)
+    {
+        if (m_bindlessTable) {
+            return;
+        }
+
+        m_bindlessTable = std::make_unique<BindlessTextureTable>(m_deviceRef, capacity);
+        for (const auto& [path, texture] : m_texturesMap) {
+            m_bindlessTable->add(*texture);
+        }
+    }
+
+    uint32_t TextureLibrary::bindlessIndex(const Texture* texture) const
+    {
+        if (!m_bindlessTable || texture == nullptr) {
+            return BindlessTextureTable::kNoTexture;
+        }
+        return m_bindlessTable->indexOf(*texture);
+    }
+
 } // namespace vkcommon
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef TEXTURE_LIB_H
 #define TEXTURE_LIB_H
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <filesystem>
@@ -10,12 +11,13 @@ namespace vkcommon
     class Device;
     class MemoryAllocator;
     class Texture;
-    class CommandPool;
+    class UploadContext;
+    class BindlessTextureTable;
 
     class TextureLibrary {
     public:
         TextureLibrary(const Device& device, MemoryAllocator& allocator);
-        ~TextureLibrary() = default;
+        ~TextureLibrary();
 
         TextureLibrary(const TextureLibrary&) = delete;
         TextureLibrary& operator=(const TextureLibrary&) = delete;
@@ -25,14 +27,23 @@ namespace vkcommon
 
         std::shared_ptr<Texture> getOrLoadTexture(
             const std::filesystem::path& path,
-            const CommandPool& cmdPool
+            UploadContext& uploadContext
         );
 
+        // Registers every texture, loaded so far and from now on, in a bindless
+        // table materials index into. Throws without descriptor indexing.
+        void enableBindless(uint32_t capacity = 4096);
+        // Null until enableBindless()
+        const BindlessTextureTable* bindlessTable() const { return m_bindlessTable.get(); }
+        // BindlessTextureTable::kNoTexture for null textures or without a table
+        uint32_t bindlessIndex(const Texture* texture) const;
+
     private:
         const Device& m_deviceRef;
         MemoryAllocator& m_allocatorRef;
 
         std::unordered_map<std::filesystem::path, std::shared_ptr<Texture>> m_texturesMap;
+        std::unique_ptr<BindlessTextureTable> m_bindlessTable;
     };
 
 } // namespace vkcommon
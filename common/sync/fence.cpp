@@ -47,6 +47,10 @@ namespace vkcommon {
         }
     }
 
+    bool Fence::signaled() const {
+        return vkGetFenceStatus(m_device.handle(), m_fence) == VK_SUCCESS;
+    }
+
     void Fence::cleanup() {
         if (m_fence != VK_NULL_HANDLE) {
             vkDestroyFence(m_device.handle(), m_fence, nullptr);
@@ -22,6 +22,7 @@ namespace vkcommon {
 
         void wait(uint64_t timeout = UINT64_MAX) const;
         void reset() const;
+        bool signaled() const;
 
         VkFence handle() const { return m_fence; }
 
@@ -1,42 +1,107 @@
 #include "frame_manager.h"
 
 #include "core/device.h"
+#include "graphics/command_pool.h"
+
+#include <algorithm>
+#include <iterator>
 
 namespace vkcommon {
     FrameManager::FrameManager(const Device& device, uint32_t maxFramesInFlight)
         : m_deviceRef(device), m_maxFramesInFlight(maxFramesInFlight) {
         m_framesyncs.reserve(maxFramesInFlight);
+        m_commandPools.resize(maxFramesInFlight);
         for (uint32_t i = 0; i < maxFramesInFlight; ++i) {
             m_framesyncs.emplace_back(device);
+            m_commandPools[i].pool = std::make_unique<CommandPool>(
+                device, device.graphicsQueueFamily(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
         }
     }
 
+    FrameManager::~FrameManager() {
+        runDeferred(true);
+    }
+
     FrameManager::FrameManager(FrameManager&& other) noexcept
         : m_deviceRef(other.m_deviceRef)
         , m_framesyncs(std::move(other.m_framesyncs))
+        , m_commandPools(std::move(other.m_commandPools))
         , m_currentFrame(other.m_currentFrame)
-        , m_maxFramesInFlight(other.m_maxFramesInFlight) {
+        , m_maxFramesInFlight(other.m_maxFramesInFlight)
+        , m_frameNumber(other.m_frameNumber)
+        , m_deferred(std::move(other.m_deferred)) {
         other.m_currentFrame = 0;
         other.m_maxFramesInFlight = 0;
+        other.m_frameNumber = 0;
+        other.m_deferred.clear();
     }
 
     FrameManager& FrameManager::operator=(FrameManager&& other) noexcept {
         if (this != &other) {
+            runDeferred(true);
+
             m_framesyncs = std::move(other.m_framesyncs);
+            m_commandPools = std::move(other.m_commandPools);
             m_currentFrame = other.m_currentFrame;
             m_maxFramesInFlight = other.m_maxFramesInFlight;
+            m_frameNumber = other.m_frameNumber;
+            m_deferred = std::move(other.m_deferred);
 
             other.m_currentFrame = 0;
             other.m_maxFramesInFlight = 0;
+            other.m_frameNumber = 0;
+            other.m_deferred.clear();
         }
         return *this;
     }
 
-    void FrameManager::waitForFence() const {
+    void FrameManager::waitForFence() {
         m_framesyncs[m_currentFrame].waitForFence();
+
+        // Everything recorded for this slot has finished, so its buffers
+        // go back to the initial state in one call instead of one by one
+        FrameCommandPool& commandPool = m_commandPools[m_currentFrame];
+        commandPool.pool->reset();
+        commandPool.usedPrimary = 0;
+        commandPool.usedSecondary = 0;
+
+        runDeferred(false);
+    }
+
+    VkCommandBuffer FrameManager::allocateCommandBuffer(VkCommandBufferLevel level) {
+        FrameCommandPool& commandPool = m_commandPools[m_currentFrame];
+        bool primary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        std::vector<VkCommandBuffer>& buffers = primary ? commandPool.primary : commandPool.secondary;
+        size_t& used = primary ? commandPool.usedPrimary : commandPool.usedSecondary;
+
+        if (used == buffers.size()) {
+            buffers.push_back(commandPool.pool->allocateSingleBuffer(level));
+        }
+        return buffers[used++];
     }
 
     void FrameManager::resetFence() const {
         m_framesyncs[m_currentFrame].resetFence();
     }
+
+    void FrameManager::deferDestroy(std::function<void()> destroy) {
+        // The current frame may already use the object, and it is the last
+        // to finish once the fence of its slot comes around again
+        m_deferred.push_back({ m_frameNumber + m_maxFramesInFlight, std::move(destroy) });
+    }
+
+    void FrameManager::runDeferred(bool all) {
+        auto firstPending = std::stable_partition(m_deferred.begin(), m_deferred.end(),
+            [this, all](const DeferredDestroy& deferred) { return all || deferred.frameNumber <= m_frameNumber; });
+
+        // Moved out first, a destroy may defer another one
+        std::vector<DeferredDestroy> ready(
+            std::make_move_iterator(m_deferred.begin()),
+            std::make_move_iterator(firstPending));
+        m_deferred.erase(m_deferred.begin(), firstPending);
+
+        for (auto& deferred : ready) {
+            deferred.destroy();
+        }
+    }
 } // namespace vkcommon
\ No newline at end of file
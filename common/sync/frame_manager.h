@@ -3,6 +3,9 @@
 
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "sync/frame_sync.h"
@@ -10,11 +13,16 @@
 namespace vkcommon {
 
     class Device;
+    class CommandPool;
 
+    // Fences, semaphores and a transient command pool per frame in flight.
+    // Command buffers come from the current frame's pool and are recycled
+    // together by one vkResetCommandPool once that frame's fence signals.
     class FrameManager {
     public:
         FrameManager(const Device& device, uint32_t maxFramesInFlight);
-        ~FrameManager() = default;
+        // Runs whatever is still deferred, so the device must be idle
+        ~FrameManager();
 
         // Disable copying
         FrameManager(const FrameManager&) = delete;
@@ -24,17 +32,52 @@ namespace vkcommon {
         FrameManager(FrameManager&& other) noexcept;
         FrameManager& operator=(FrameManager&& other) noexcept;
 
-        void waitForFence() const;
+        // Also resets the frame's command pool and runs the deferred destroys
+        // whose frames have all retired
+        void waitForFence();
         void resetFence() const;
-        void nextFrame() { m_currentFrame = (m_currentFrame + 1) % m_maxFramesInFlight; }
+        void nextFrame() {
+            m_currentFrame = (m_currentFrame + 1) % m_maxFramesInFlight;
+            m_frameNumber++;
+        }
+
+        // Calls destroy once every frame submitted so far, including the
+        // current one, has finished on the GPU. For objects replaced while
+        // frames are in flight, e.g. a pipeline rebuilt on shader reload.
+        void deferDestroy(std::function<void()> destroy);
+
+        // Begin-ready buffer from the current frame's pool, valid until the
+        // next waitForFence() on this frame. Buffers freed by earlier resets
+        // are handed out again before new ones are allocated.
+        VkCommandBuffer allocateCommandBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        const CommandPool& currentCommandPool() const { return *m_commandPools[m_currentFrame].pool; }
 
         uint32_t currentFrame() const { return m_currentFrame; }
         const FrameSync& getCurrentSync() const { return m_framesyncs[m_currentFrame]; }
 
     private:
+        struct DeferredDestroy {
+            uint64_t frameNumber;   // safe once this frame's fence is waited on
+            std::function<void()> destroy;
+        };
+
+        // Buffers stay allocated across resets, only the used counts rewind
+        struct FrameCommandPool {
+            std::unique_ptr<CommandPool> pool;
+            std::vector<VkCommandBuffer> primary;
+            std::vector<VkCommandBuffer> secondary;
+            size_t usedPrimary{ 0 };
+            size_t usedSecondary{ 0 };
+        };
+
+        void runDeferred(bool all);
+
         std::vector<FrameSync> m_framesyncs;
+        std::vector<FrameCommandPool> m_commandPools;
         uint32_t m_currentFrame{ 0 };
         uint32_t m_maxFramesInFlight;
+        uint64_t m_frameNumber{ 0 };
+        std::vector<DeferredDestroy> m_deferred;
 
         const Device& m_deviceRef;
     };
@@ -0,0 +1,174 @@
+#include "resources/model/frustum.h"
+#include "resources/model/sphere_culler.h"
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using vkcommon::Frustum;
+using vkcommon::SphereCuller;
+
+namespace {
+    int g_failures = 0;
+
+    void check(bool condition, const char* expression, int line) {
+        if (!condition) {
+            std::cerr << "line " << line << ": check failed: " << expression << std::endl;
+            g_failures++;
+        }
+    }
+
+    // Relative to the plane distance, which loses digits to cancellation for far planes
+    bool nearlyEqual(const glm::vec4& a, const glm::vec4& b) {
+        const float epsilon = 1e-5f * std::max(1.0f, std::fabs(b.w));
+        return std::fabs(a.x - b.x) < epsilon && std::fabs(a.y - b.y) < epsilon &&
+            std::fabs(a.z - b.z) < epsilon && std::fabs(a.w - b.w) < epsilon;
+    }
+
+    // 90 degree square frustum looking down -z, near 1 and far 100
+    Frustum cameraFrustum() {
+        return Frustum::fromMatrix(glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f));
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void testIdentityPlanes() {
+    // The clip volume itself, every plane one unit from the origin
+    Frustum frustum = Frustum::fromMatrix(glm::mat4(1.0f));
+    const auto& planes = frustum.planes();
+
+    CHECK(nearlyEqual(planes[0], glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)));    // Left
+    CHECK(nearlyEqual(planes[1], glm::vec4(-1.0f, 0.0f, 0.0f, 1.0f)));   // Right
+    CHECK(nearlyEqual(planes[2], glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)));    // Bottom
+    CHECK(nearlyEqual(planes[3], glm::vec4(0.0f, -1.0f, 0.0f, 1.0f)));   // Top
+    CHECK(nearlyEqual(planes[4], glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)));    // Near
+    CHECK(nearlyEqual(planes[5], glm::vec4(0.0f, 0.0f, -1.0f, 1.0f)));   // Far
+}
+
+static void testScaledTranslatedPlanes() {
+    // x_clip = 0.5 * x + 1, so the volume spans x in [-4, 0]
+    glm::mat4 m(1.0f);
+    m[0][0] = 0.5f;
+    m[3][0] = 1.0f;
+    Frustum frustum = Frustum::fromMatrix(m);
+    const auto& planes = frustum.planes();
+
+    // Normalized, so w is the distance from the origin
+    CHECK(nearlyEqual(planes[0], glm::vec4(1.0f, 0.0f, 0.0f, 4.0f)));
+    CHECK(nearlyEqual(planes[1], glm::vec4(-1.0f, 0.0f, 0.0f, 0.0f)));
+    CHECK(nearlyEqual(planes[2], glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)));
+}
+
+static void testPerspectivePlanes() {
+    Frustum frustum = cameraFrustum();
+    const auto& planes = frustum.planes();
+    const float s = std::sqrt(0.5f);
+
+    // Side planes pass through the eye at 45 degrees
+    CHECK(nearlyEqual(planes[0], glm::vec4(s, 0.0f, -s, 0.0f)));
+    CHECK(nearlyEqual(planes[1], glm::vec4(-s, 0.0f, -s, 0.0f)));
+    CHECK(nearlyEqual(planes[2], glm::vec4(0.0f, s, -s, 0.0f)));
+    CHECK(nearlyEqual(planes[3], glm::vec4(0.0f, -s, -s, 0.0f)));
+    CHECK(nearlyEqual(planes[4], glm::vec4(0.0f, 0.0f, -1.0f, -1.0f)));
+    CHECK(nearlyEqual(planes[5], glm::vec4(0.0f, 0.0f, 1.0f, 100.0f)));
+}
+
+static void testSpheres() {
+    Frustum frustum = cameraFrustum();
+
+    // Inside
+    CHECK(frustum.intersects({ glm::vec3(0.0f, 0.0f, -10.0f), 1.0f }));
+    CHECK(frustum.intersects({ glm::vec3(5.0f, -5.0f, -50.0f), 0.1f }));
+
+    // Outside, one case per plane
+    CHECK(!frustum.intersects({ glm::vec3(-20.0f, 0.0f, -10.0f), 1.0f }));
+    CHECK(!frustum.intersects({ glm::vec3(20.0f, 0.0f, -10.0f), 1.0f }));
+    CHECK(!frustum.intersects({ glm::vec3(0.0f, -20.0f, -10.0f), 1.0f }));
+    CHECK(!frustum.intersects({ glm::vec3(0.0f, 20.0f, -10.0f), 1.0f }));
+    CHECK(!frustum.intersects({ glm::vec3(0.0f, 0.0f, 5.0f), 1.0f }));
+    CHECK(!frustum.intersects({ glm::vec3(0.0f, 0.0f, -200.0f), 1.0f }));
+
+    // Straddling a plane counts as visible
+    CHECK(frustum.intersects({ glm::vec3(11.0f, 0.0f, -10.0f), 2.0f }));
+    CHECK(frustum.intersects({ glm::vec3(0.0f, 0.0f, -0.5f), 1.0f }));
+    CHECK(frustum.intersects({ glm::vec3(0.0f, 0.0f, -100.5f), 1.0f }));
+    // Just past the far plane
+    CHECK(!frustum.intersects({ glm::vec3(0.0f, 0.0f, -101.5f), 1.0f }));
+}
+
+static void testScalarPath() {
+    Frustum frustum = cameraFrustum();
+
+    SphereCuller culler;
+    CHECK(culler.add({ glm::vec3(0.0f, 0.0f, -10.0f), 1.0f }) == 0);
+    CHECK(culler.add({ glm::vec3(-20.0f, 0.0f, -10.0f), 1.0f }) == 1);
+    CHECK(culler.add({ glm::vec3(11.0f, 0.0f, -10.0f), 2.0f }) == 2);
+    CHECK(culler.add({ glm::vec3(0.0f, 0.0f, 5.0f), 1.0f }) == 3);
+
+    std::vector<uint32_t> visible{ 7, 8, 9 };
+    culler.cull(frustum, visible, SphereCuller::Path::Scalar);
+    CHECK((visible == std::vector<uint32_t>{ 0, 2 }));
+
+    SphereCuller empty;
+    empty.cull(frustum, visible, SphereCuller::Path::Scalar);
+    CHECK(visible.empty());
+}
+
+static void testSimdPathsMatchScalar() {
+    Frustum frustum = Frustum::fromMatrix(
+        glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f) *
+        glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> radius(0.1f, 2.0f);
+
+    const SphereCuller::Path paths[] = { SphereCuller::Path::SSE, SphereCuller::Path::AVX2 };
+
+    // Counts around the 4 and 8 wide blocks exercise the scalar tails
+    for (uint32_t count : { 0u, 1u, 3u, 4u, 7u, 8u, 9u, 17u, 1003u, 10000u }) {
+        SphereCuller culler;
+        culler.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            culler.add({ glm::vec3(position(rng), position(rng), position(rng)), radius(rng) });
+        }
+
+        std::vector<uint32_t> reference;
+        culler.cull(frustum, reference, SphereCuller::Path::Scalar);
+
+        for (SphereCuller::Path path : paths) {
+            // Unsupported paths fall back to the scalar one, still checked
+            if (!SphereCuller::isSupported(path)) {
+                std::cout << SphereCuller::pathName(path) << " is not supported, checking the fallback" << std::endl;
+            }
+
+            std::vector<uint32_t> visible;
+            culler.cull(frustum, visible, path);
+            CHECK(visible == reference);
+        }
+    }
+}
+
+int main() {
+    testIdentityPlanes();
+    testScaledTranslatedPlanes();
+    testPerspectivePlanes();
+    testSpheres();
+    testScalarPath();
+    testSimdPathsMatchScalar();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "All culling checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
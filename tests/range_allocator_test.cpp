@@ -0,0 +1,139 @@
+#include "resources/memory/range_allocator.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+
+using vkcommon::RangeAllocator;
+
+namespace {
+    int g_failures = 0;
+
+    void check(bool condition, const char* expression, int line) {
+        if (!condition) {
+            std::cerr << "line " << line << ": check failed: " << expression << std::endl;
+            g_failures++;
+        }
+    }
+
+    std::optional<VkDeviceSize> at(VkDeviceSize offset) {
+        return offset;
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void testAlignment() {
+    RangeAllocator ranges(1024);
+
+    CHECK(ranges.allocate(10, 1, true) == at(0));
+    // Rounded up past the first range, the gap stays free
+    CHECK(ranges.allocate(16, 256, true) == at(256));
+    CHECK(ranges.allocate(4, 4, true) == at(12));
+    // Alignment 0 is treated as 1, and the 2 byte gap at 10 fits best
+    CHECK(ranges.allocate(2, 0, true) == at(10));
+    CHECK(ranges.used() == 32);
+    CHECK(ranges.allocate(2, 1, true) == at(16));
+}
+
+static void testGranularity() {
+    RangeAllocator ranges(4096, 1024);
+
+    CHECK(ranges.allocate(100, 1, true) == at(0));
+    // Optimal after linear moves to the next page
+    CHECK(ranges.allocate(100, 1, false) == at(1024));
+    // Linear after linear shares the page
+    CHECK(ranges.allocate(100, 1, true) == at(100));
+    // Too big for the gap before 1024, and linear after optimal moves to the next page
+    CHECK(ranges.allocate(1000, 1, true) == at(2048));
+    // Optimal after optimal packs tightly
+    RangeAllocator optimal(4096, 1024);
+    CHECK(optimal.allocate(100, 1, false) == at(0));
+    CHECK(optimal.allocate(100, 1, false) == at(100));
+}
+
+static void testGranularityBeforeNeighbour() {
+    RangeAllocator ranges(2048, 1024);
+
+    CHECK(ranges.allocate(512, 1, true) == at(0));
+    CHECK(ranges.allocate(512, 1, true) == at(512));
+    CHECK(ranges.allocate(100, 1, false) == at(1024));
+    ranges.free(512);
+
+    // The hole ends on the page before the optimal range, so linear fits
+    CHECK(ranges.allocate(512, 1, true) == at(512));
+    ranges.free(512);
+    // An optimal range in the hole would share page 0 with the linear range at 0
+    CHECK(ranges.allocate(256, 1, false) == at(1124));
+}
+
+static void testBestFit() {
+    RangeAllocator ranges(1000);
+
+    CHECK(ranges.allocate(100, 1, true) == at(0));
+    CHECK(ranges.allocate(300, 1, true) == at(100));
+    CHECK(ranges.allocate(100, 1, true) == at(400));
+    CHECK(ranges.allocate(200, 1, true) == at(500));
+    CHECK(ranges.allocate(100, 1, true) == at(700));
+    // Free: 300 at 100, 200 at 500 and the 200 tail at 800
+    ranges.free(100);
+    ranges.free(500);
+
+    // Smallest fitting range, the first of equal ones
+    CHECK(ranges.allocate(150, 1, true) == at(500));
+    CHECK(ranges.allocate(200, 1, true) == at(800));
+    CHECK(ranges.allocate(250, 1, true) == at(100));
+}
+
+static void testMergeOnFree() {
+    RangeAllocator ranges(1000);
+
+    CHECK(ranges.allocate(400, 1, true) == at(0));
+    CHECK(ranges.allocate(400, 1, true) == at(400));
+    CHECK(ranges.allocate(200, 1, true) == at(800));
+
+    // Neither neighbour is free yet, then both are
+    ranges.free(0);
+    ranges.free(800);
+    CHECK(ranges.allocate(500, 1, true) == std::nullopt);
+    ranges.free(400);
+    CHECK(ranges.empty());
+
+    CHECK(ranges.allocate(1000, 1, true) == at(0));
+}
+
+static void testExhaustion() {
+    RangeAllocator ranges(256);
+
+    CHECK(ranges.allocate(0, 1, true) == std::nullopt);
+    CHECK(ranges.allocate(257, 1, true) == std::nullopt);
+    CHECK(ranges.allocate(256, 1, true) == at(0));
+    CHECK(ranges.allocate(1, 1, true) == std::nullopt);
+    CHECK(ranges.used() == ranges.size());
+
+    bool threw = false;
+    try {
+        ranges.free(128);
+    }
+    catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+int main() {
+    testAlignment();
+    testGranularity();
+    testGranularityBeforeNeighbour();
+    testBestFit();
+    testMergeOnFree();
+    testExhaustion();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "All range allocator checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
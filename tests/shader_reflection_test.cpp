@@ -0,0 +1,386 @@
+#include "graphics/shader_reflection.h"
+
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using vkcommon::ReflectedBinding;
+using vkcommon::ShaderReflection;
+
+namespace {
+    int g_failures = 0;
+
+    void check(bool condition, const char* expression, int line) {
+        if (!condition) {
+            std::cerr << "line " << line << ": check failed: " << expression << std::endl;
+            g_failures++;
+        }
+    }
+
+    // Opcodes, decorations and storage classes from the SPIR-V spec
+    enum : uint32_t {
+        OpEntryPoint = 15,
+        OpTypeInt = 21,
+        OpTypeFloat = 22,
+        OpTypeVector = 23,
+        OpTypeMatrix = 24,
+        OpTypeImage = 25,
+        OpTypeSampledImage = 27,
+        OpTypeArray = 28,
+        OpTypeRuntimeArray = 29,
+        OpTypeStruct = 30,
+        OpTypePointer = 32,
+        OpConstant = 43,
+        OpVariable = 59,
+        OpDecorate = 71,
+        OpMemberDecorate = 72,
+
+        Block = 2,
+        BufferBlock = 3,
+        MatrixStride = 7,
+        BuiltIn = 11,
+        Location = 30,
+        Binding = 33,
+        DescriptorSet = 34,
+        Offset = 35,
+
+        UniformConstant = 0,
+        Input = 1,
+        Uniform = 2,
+        PushConstant = 9,
+        StorageBuffer = 12,
+
+        ExecutionModelVertex = 0,
+        ExecutionModelFragment = 4,
+    };
+
+    // Hand-assembled module: only the instructions the reflection reads,
+    // no function bodies
+    class SpirvBuilder {
+    public:
+        explicit SpirvBuilder(uint32_t executionModel) {
+            // Magic, version 1.0, generator, id bound, schema
+            m_words = { 0x07230203, 0x00010000, 0, 0, 0 };
+            // Entry point %1 named "" (one word of padding)
+            op(OpEntryPoint, { executionModel, 1, 0 });
+        }
+
+        SpirvBuilder& op(uint32_t opcode, std::initializer_list<uint32_t> operands) {
+            m_words.push_back((static_cast<uint32_t>(operands.size() + 1) << 16) | opcode);
+            m_words.insert(m_words.end(), operands);
+            return *this;
+        }
+
+        SpirvBuilder& binding(uint32_t variable, uint32_t set, uint32_t binding) {
+            op(OpDecorate, { variable, DescriptorSet, set });
+            return op(OpDecorate, { variable, Binding, binding });
+        }
+
+        std::vector<uint32_t> build(uint32_t idBound) const {
+            std::vector<uint32_t> words = m_words;
+            words[3] = idBound;
+            return words;
+        }
+
+    private:
+        std::vector<uint32_t> m_words;
+    };
+
+    ShaderReflection reflect(const std::vector<uint32_t>& words) {
+        return ShaderReflection(words.data(), words.size());
+    }
+
+    // UBO at set 0 binding 0, a 4x4 matrix pushed at offset 0 and three inputs:
+    // vec3 at 0, vec2 at 2 and a mat4 at 4, plus a built-in that is skipped
+    std::vector<uint32_t> vertexModule() {
+        SpirvBuilder spirv(ExecutionModelVertex);
+        spirv.op(OpTypeFloat, { 2, 32 })
+            .op(OpTypeVector, { 3, 2, 3 })
+            .op(OpTypeVector, { 4, 2, 2 })
+            .op(OpTypeVector, { 5, 2, 4 })
+            .op(OpTypeMatrix, { 6, 5, 4 })
+            // Inputs
+            .op(OpTypePointer, { 7, Input, 3 })
+            .op(OpVariable, { 7, 8, Input })
+            .op(OpDecorate, { 8, Location, 0 })
+            .op(OpTypePointer, { 9, Input, 4 })
+            .op(OpVariable, { 9, 10, Input })
+            .op(OpDecorate, { 10, Location, 2 })
+            .op(OpTypePointer, { 11, Input, 6 })
+            .op(OpVariable, { 11, 12, Input })
+            .op(OpDecorate, { 12, Location, 4 })
+            .op(OpVariable, { 7, 13, Input })
+            .op(OpDecorate, { 13, BuiltIn, 42 })
+            // Push constant block { mat4 model; }
+            .op(OpTypeStruct, { 14, 6 })
+            .op(OpDecorate, { 14, Block })
+            .op(OpMemberDecorate, { 14, 0, Offset, 0 })
+            .op(OpMemberDecorate, { 14, 0, MatrixStride, 16 })
+            .op(OpTypePointer, { 15, PushConstant, 14 })
+            .op(OpVariable, { 15, 16, PushConstant })
+            // Uniform block { mat4 viewProj; }
+            .op(OpTypeStruct, { 17, 6 })
+            .op(OpDecorate, { 17, Block })
+            .op(OpMemberDecorate, { 17, 0, Offset, 0 })
+            .op(OpMemberDecorate, { 17, 0, MatrixStride, 16 })
+            .op(OpTypePointer, { 18, Uniform, 17 })
+            .op(OpVariable, { 18, 19, Uniform })
+            .binding(19, 0, 0);
+        return spirv.build(20);
+    }
+
+    // The same UBO, three samplers at set 1 binding 0, a runtime array at
+    // set 1 binding 1, two storage buffers in set 2 (StorageBuffer class and
+    // BufferBlock) and a float pushed at offset 128
+    std::vector<uint32_t> fragmentModule() {
+        SpirvBuilder spirv(ExecutionModelFragment);
+        spirv.op(OpTypeFloat, { 2, 32 })
+            .op(OpTypeVector, { 3, 2, 4 })
+            .op(OpTypeMatrix, { 4, 3, 4 })
+            .op(OpTypeStruct, { 5, 4 })
+            .op(OpDecorate, { 5, Block })
+            .op(OpMemberDecorate, { 5, 0, Offset, 0 })
+            .op(OpMemberDecorate, { 5, 0, MatrixStride, 16 })
+            .op(OpTypePointer, { 6, Uniform, 5 })
+            .op(OpVariable, { 6, 7, Uniform })
+            .binding(7, 0, 0)
+            // sampler2D textures[3]
+            .op(OpTypeImage, { 8, 2, 1, 0, 0, 0, 1, 0 })
+            .op(OpTypeSampledImage, { 9, 8 })
+            .op(OpTypeInt, { 10, 32, 0 })
+            .op(OpConstant, { 10, 11, 3 })
+            .op(OpTypeArray, { 12, 9, 11 })
+            .op(OpTypePointer, { 13, UniformConstant, 12 })
+            .op(OpVariable, { 13, 14, UniformConstant })
+            .binding(14, 1, 0)
+            // sampler2D table[]
+            .op(OpTypeRuntimeArray, { 15, 9 })
+            .op(OpTypePointer, { 16, UniformConstant, 15 })
+            .op(OpVariable, { 16, 17, UniformConstant })
+            .binding(17, 1, 1)
+            // Storage buffers
+            .op(OpTypeStruct, { 18, 2 })
+            .op(OpDecorate, { 18, Block })
+            .op(OpTypePointer, { 19, StorageBuffer, 18 })
+            .op(OpVariable, { 19, 20, StorageBuffer })
+            .binding(20, 2, 0)
+            .op(OpTypeStruct, { 21, 2 })
+            .op(OpDecorate, { 21, BufferBlock })
+            .op(OpTypePointer, { 22, Uniform, 21 })
+            .op(OpVariable, { 22, 23, Uniform })
+            .binding(23, 2, 1)
+            // Push constant block { layout(offset = 128) float opacity; }
+            .op(OpTypeStruct, { 24, 2 })
+            .op(OpDecorate, { 24, Block })
+            .op(OpMemberDecorate, { 24, 0, Offset, 128 })
+            .op(OpTypePointer, { 25, PushConstant, 24 })
+            .op(OpVariable, { 25, 26, PushConstant });
+        return spirv.build(27);
+    }
+
+    bool hasBinding(const ReflectedBinding& binding, uint32_t set, uint32_t index,
+        VkDescriptorType type, uint32_t count, VkShaderStageFlags stages) {
+        return binding.set == set && binding.binding == index && binding.type == type
+            && binding.count == count && binding.stages == stages;
+    }
+
+    template <typename Function>
+    bool throwsRuntimeError(Function function) {
+        try {
+            function();
+        }
+        catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void testDescriptorBindings() {
+    ShaderReflection fragment = reflect(fragmentModule());
+    const auto& bindings = fragment.bindings();
+    const VkShaderStageFlags stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    CHECK(fragment.stages() == stage);
+    CHECK(fragment.setCount() == 3);
+    CHECK(bindings.size() == 5);
+    if (bindings.size() == 5) {
+        // Sorted by set, then binding
+        CHECK(hasBinding(bindings[0], 0, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, stage));
+        CHECK(hasBinding(bindings[1], 1, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3, stage));
+        // Runtime-sized arrays count 0
+        CHECK(hasBinding(bindings[2], 1, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, stage));
+        CHECK(hasBinding(bindings[3], 2, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stage));
+        CHECK(hasBinding(bindings[4], 2, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stage));
+    }
+}
+
+static void testLayoutBindings() {
+    ShaderReflection fragment = reflect(fragmentModule());
+
+    auto textures = fragment.layoutBindings(1, {}, 64);
+    CHECK(textures.size() == 2);
+    if (textures.size() == 2) {
+        CHECK(textures[0].descriptorCount == 3);
+        CHECK(textures[1].descriptorCount == 64);
+    }
+
+    auto globals = fragment.layoutBindings(0, { 0 });
+    CHECK(globals.size() == 1 && globals[0].descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+
+    auto buffers = fragment.layoutBindings(2, { 1 });
+    CHECK(buffers.size() == 2);
+    if (buffers.size() == 2) {
+        CHECK(buffers[0].descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        CHECK(buffers[1].descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC);
+    }
+
+    CHECK(fragment.layoutBindings(3).empty());
+}
+
+static void testVertexInputs() {
+    ShaderReflection vertex = reflect(vertexModule());
+    const auto& inputs = vertex.vertexInputs();
+
+    // The mat4 takes locations 4 to 7, the built-in none
+    CHECK(inputs.size() == 6);
+    if (inputs.size() == 6) {
+        CHECK(inputs[0].location == 0 && inputs[0].format == VK_FORMAT_R32G32B32_SFLOAT);
+        CHECK(inputs[1].location == 2 && inputs[1].format == VK_FORMAT_R32G32_SFLOAT);
+        for (uint32_t column = 0; column < 4; column++) {
+            CHECK(inputs[2 + column].location == 4 + column);
+            CHECK(inputs[2 + column].format == VK_FORMAT_R32G32B32A32_SFLOAT);
+        }
+    }
+
+    // Only vertex shaders report inputs
+    CHECK(reflect(fragmentModule()).vertexInputs().empty());
+}
+
+static void testPushConstantRanges() {
+    ShaderReflection vertex = reflect(vertexModule());
+    ShaderReflection fragment = reflect(fragmentModule());
+
+    CHECK(vertex.pushConstantRanges().size() == 1);
+    if (vertex.pushConstantRanges().size() == 1) {
+        const VkPushConstantRange& range = vertex.pushConstantRanges()[0];
+        CHECK(range.stageFlags == VK_SHADER_STAGE_VERTEX_BIT && range.offset == 0 && range.size == 64);
+    }
+
+    // Starts at the block's first member, not at 0
+    CHECK(fragment.pushConstantRanges().size() == 1);
+    if (fragment.pushConstantRanges().size() == 1) {
+        const VkPushConstantRange& range = fragment.pushConstantRanges()[0];
+        CHECK(range.stageFlags == VK_SHADER_STAGE_FRAGMENT_BIT && range.offset == 128 && range.size == 4);
+    }
+
+    // One range spanning both blocks, with both stages
+    ShaderReflection merged = vertex;
+    merged.merge(fragment);
+    CHECK(merged.pushConstantRanges().size() == 1);
+    if (merged.pushConstantRanges().size() == 1) {
+        const VkPushConstantRange& range = merged.pushConstantRanges()[0];
+        CHECK(range.stageFlags == (VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT));
+        CHECK(range.offset == 0 && range.size == 132);
+    }
+}
+
+static void testMerge() {
+    ShaderReflection merged = reflect(vertexModule());
+    merged.merge(reflect(fragmentModule()));
+    const VkShaderStageFlags both = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    CHECK(merged.stages() == both);
+    CHECK(merged.bindings().size() == 5);
+    if (!merged.bindings().empty()) {
+        // Shared by both stages, the rest keep the fragment stage only
+        CHECK(hasBinding(merged.bindings()[0], 0, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, both));
+        CHECK(merged.bindings()[1].stages == VK_SHADER_STAGE_FRAGMENT_BIT);
+    }
+    // Inputs come from the vertex stage
+    CHECK(merged.vertexInputs().size() == 6);
+
+    ShaderReflection reversed = reflect(fragmentModule());
+    reversed.merge(reflect(vertexModule()));
+    CHECK(reversed.hasSameLayout(merged));
+    CHECK(!reversed.hasSameLayout(reflect(fragmentModule())));
+
+    // The same binding as a storage buffer in another stage
+    SpirvBuilder conflicting(ExecutionModelVertex);
+    conflicting.op(OpTypeFloat, { 2, 32 })
+        .op(OpTypeStruct, { 3, 2 })
+        .op(OpDecorate, { 3, Block })
+        .op(OpTypePointer, { 4, StorageBuffer, 3 })
+        .op(OpVariable, { 4, 5, StorageBuffer })
+        .binding(5, 0, 0);
+    ShaderReflection fragment = reflect(fragmentModule());
+    CHECK(throwsRuntimeError([&] { fragment.merge(reflect(conflicting.build(6))); }));
+}
+
+static void testValidateVertexInput() {
+    ShaderReflection vertex = reflect(vertexModule());
+
+    std::vector<VkVertexInputAttributeDescription> attributes = {
+        { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0 },
+        { 2, 0, VK_FORMAT_R32G32_SFLOAT, 12 },
+        { 4, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 0 },
+        { 5, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 16 },
+        { 6, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 32 },
+        { 7, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 48 },
+        // Attributes the shader does not read are fine
+        { 9, 0, VK_FORMAT_R32_UINT, 20 },
+    };
+    CHECK(!throwsRuntimeError([&] { vertex.validateVertexInput(attributes); }));
+
+    // Format mismatch
+    std::vector<VkVertexInputAttributeDescription> wrongFormat = attributes;
+    wrongFormat[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+    CHECK(throwsRuntimeError([&] { vertex.validateVertexInput(wrongFormat); }));
+
+    // Missing location
+    std::vector<VkVertexInputAttributeDescription> missing = attributes;
+    missing.erase(missing.begin() + 5);
+    CHECK(throwsRuntimeError([&] { vertex.validateVertexInput(missing); }));
+
+    // Nothing to check without vertex inputs
+    CHECK(!throwsRuntimeError([&] { reflect(fragmentModule()).validateVertexInput({}); }));
+}
+
+static void testInvalidModules() {
+    std::vector<uint32_t> badMagic = vertexModule();
+    badMagic[0] = 0;
+    CHECK(throwsRuntimeError([&] { reflect(badMagic); }));
+
+    // Last instruction claims more words than are left
+    std::vector<uint32_t> truncated = vertexModule();
+    truncated.pop_back();
+    CHECK(throwsRuntimeError([&] { reflect(truncated); }));
+
+    // Id past the bound
+    std::vector<uint32_t> outOfRange = vertexModule();
+    outOfRange[3] = 10;
+    CHECK(throwsRuntimeError([&] { reflect(outOfRange); }));
+
+    CHECK(throwsRuntimeError([] { ShaderReflection(nullptr, 0); }));
+}
+
+int main() {
+    testDescriptorBindings();
+    testLayoutBindings();
+    testVertexInputs();
+    testPushConstantRanges();
+    testMerge();
+    testValidateVertexInput();
+    testInvalidModules();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "All shader reflection checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -10,7 +10,7 @@ void CubeApp::initVulkan() {
     m_descriptorSetLayout.addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT);
     m_descriptorSetLayout.create();
 
-    m_texture.loadFromFile("D:\\Projects\\Vulkan-Toybox\\toys\\cube\\dice_texture.png", m_commandPool);
+    m_texture.loadFromFile("D:\\Projects\\Vulkan-Toybox\\toys\\cube\\dice_texture.png", m_uploadContext);
     m_texture.createSampler();
 
     m_uniformBuffer.create(sizeof(UniformBufferObject), MAX_FRAMES_IN_FLIGHT);
@@ -57,7 +57,10 @@ void CubeApp::initVulkan() {
         m_depthBuffer.imageView());
 
     createVertexBuffer();
-    createCommandBuffers();
+
+    // Submit texture and vertex uploads together
+    m_uploadContext.waitIdle();
+
 }
 
 void CubeApp::createVertexBuffer() {
@@ -118,18 +121,11 @@ void CubeApp::createVertexBuffer() {
     };
 
 
-    m_vertexBuffer.createVertexBuffer(vertices, m_commandPool);
-    m_vertexBuffer.createIndexBuffer(indices, m_commandPool);
-}
-
-void CubeApp::createCommandBuffers() {
-    m_commandBuffers = m_commandPool.allocateBuffers(MAX_FRAMES_IN_FLIGHT);
+    m_vertexBuffer.createVertexBuffer(vertices, m_uploadContext);
+    m_vertexBuffer.createIndexBuffer(indices, m_uploadContext);
 }
 
-void CubeApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
-    // Begin command buffer recording
-    m_commandPool.beginCommandBuffer(commandBuffer, 0);
-
+void CubeApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex) {
     std::vector<VkClearValue> clearValues(2);
     clearValues[0].color = { {0.9f, 0.9f, 0.9f, 1.0f} };
     clearValues[1].depthStencil = { 1.0f, 0 };
@@ -152,7 +148,7 @@ void CubeApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageI
         m_pipeline->layout(),
         0,  // First set
         1,  // One set
-        &m_descriptorSets[m_frameManager.currentFrame()],
+        &m_descriptorSets[frameIndex],
         0,
         nullptr
     );
@@ -166,9 +162,21 @@ void CubeApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageI
 
     // End render pass
     m_pipeline->renderPass().end(commandBuffer);
+}
+
+VkCommandBuffer CubeApp::frameCommandBuffer(uint32_t imageIndex) {
+    if (m_prerecordCommands) {
+        return m_prerecordedCommands.get(m_frameManager.currentFrame(), imageIndex,
+            [this](VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t image) {
+                recordCommandBuffer(commandBuffer, frameIndex, image);
+            });
+    }
 
-    // End command buffer recording
-    m_commandPool.endCommandBuffer(commandBuffer);
+    VkCommandBuffer commandBuffer = m_frameManager.allocateCommandBuffer();
+    m_frameManager.currentCommandPool().beginCommandBuffer(commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    recordCommandBuffer(commandBuffer, m_frameManager.currentFrame(), imageIndex);
+    m_frameManager.currentCommandPool().endCommandBuffer(commandBuffer);
+    return commandBuffer;
 }
 
 void CubeApp::updateUniformBuffer(uint32_t currentImage)
@@ -225,8 +233,7 @@ void CubeApp::drawFrame() {
 
     m_frameManager.resetFence();
 
-    vkResetCommandBuffer(m_commandBuffers[m_frameManager.currentFrame()], 0);
-    recordCommandBuffer(m_commandBuffers[m_frameManager.currentFrame()], imageIndex);
+    VkCommandBuffer commandBuffer = frameCommandBuffer(imageIndex);
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -237,7 +244,7 @@ void CubeApp::drawFrame() {
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffers[m_frameManager.currentFrame()];
+    submitInfo.pCommandBuffers = &commandBuffer;
 
     VkSemaphore signalSemaphores[] = { m_frameManager.getCurrentSync().renderFinished() };
     submitInfo.signalSemaphoreCount = 1;
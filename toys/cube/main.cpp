@@ -1,9 +1,17 @@
 #include "cube_app.h"
 
+#include <cstring>
 #include <iostream>
 
-int main() {
-    CubeApp app;
+int main(int argc, char* argv[]) {
+    bool prerecordCommands = true;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--record-every-frame") == 0) {
+            prerecordCommands = false;
+        }
+    }
+
+    CubeApp app{ prerecordCommands };
 
     try {
         app.run();
@@ -0,0 +1,93 @@
+// Microbenchmark of SphereCuller: culled spheres per second for every
+// supported path at 10k to 1M spheres, to catch regressions. No window or
+// device is created; tests/culling_test checks that the paths agree.
+
+#include "resources/model/sphere_culler.h"
+#include "resources/model/frustum.h"
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    using vkcommon::SphereCuller;
+
+    // Spheres scattered around the camera, roughly a quarter end up visible
+    SphereCuller makeSpheres(uint32_t count) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> radius(0.1f, 2.0f);
+
+        SphereCuller culler;
+        culler.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            culler.add({ glm::vec3(position(rng), position(rng), position(rng)), radius(rng) });
+        }
+        return culler;
+    }
+
+    // Best of several runs, each long enough to be above timer resolution
+    double spheresPerSecond(const SphereCuller& culler,
+        const vkcommon::Frustum& frustum,
+        SphereCuller::Path path,
+        std::vector<uint32_t>& visible) {
+        using Clock = std::chrono::steady_clock;
+
+        const uint32_t iterations = std::max<uint32_t>(1, static_cast<uint32_t>(20'000'000 / culler.size()));
+        double best = 0.0;
+
+        for (int run = 0; run < 5; run++) {
+            auto start = Clock::now();
+            for (uint32_t i = 0; i < iterations; i++) {
+                culler.cull(frustum, visible, path);
+            }
+            std::chrono::duration<double> elapsed = Clock::now() - start;
+
+            best = std::max(best, static_cast<double>(culler.size()) * iterations / elapsed.count());
+        }
+
+        return best;
+    }
+}
+
+int main() {
+    glm::mat4 view = glm::lookAt(
+        glm::vec3(0.0f, 0.0f, 0.0f),
+        glm::vec3(1.0f, 0.0f, 1.0f),
+        glm::vec3(0.0f, 1.0f, 0.0f)
+    );
+    glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f);
+    vkcommon::Frustum frustum = vkcommon::Frustum::fromMatrix(proj * view);
+
+    const SphereCuller::Path paths[] = {
+        SphereCuller::Path::Scalar,
+        SphereCuller::Path::SSE,
+        SphereCuller::Path::AVX2
+    };
+
+    std::printf("%10s %8s %10s %16s\n", "spheres", "path", "visible", "spheres/s");
+
+    for (uint32_t count : { 10'000u, 100'000u, 1'000'000u }) {
+        SphereCuller culler = makeSpheres(count);
+
+        for (SphereCuller::Path path : paths) {
+            if (!SphereCuller::isSupported(path)) {
+                continue;
+            }
+
+            std::vector<uint32_t> visible;
+            double rate = spheresPerSecond(culler, frustum, path, visible);
+
+            std::printf("%10u %8s %10zu %16.0f\n", count, SphereCuller::pathName(path), visible.size(), rate);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -10,7 +10,7 @@ void Explosion::initVulkan() {
     m_descriptorSetLayout.addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT);
     m_descriptorSetLayout.create();
 
-    m_texture.loadFromFile("D:\\Projects\\Vulkan-Toybox\\toys\\cube\\dice_texture.png", m_commandPool);
+    m_texture.loadFromFile("D:\\Projects\\Vulkan-Toybox\\toys\\cube\\dice_texture.png", m_uploadContext);
     m_texture.createSampler();
 
     m_uniformBuffer.create(sizeof(UniformBufferObject), MAX_FRAMES_IN_FLIGHT);
@@ -58,7 +58,10 @@ void Explosion::initVulkan() {
         m_depthBuffer.imageView());
 
     createVertexBuffer();
-    createCommandBuffers();
+
+    // Submit texture and vertex uploads together
+    m_uploadContext.waitIdle();
+
 }
 
 void Explosion::createVertexBuffer() {
@@ -119,18 +122,11 @@ void Explosion::createVertexBuffer() {
     };
 
 
-    m_vertexBuffer.createVertexBuffer(vertices, m_commandPool);
-    m_vertexBuffer.createIndexBuffer(indices, m_commandPool);
-}
-
-void Explosion::createCommandBuffers() {
-    m_commandBuffers = m_commandPool.allocateBuffers(MAX_FRAMES_IN_FLIGHT);
+    m_vertexBuffer.createVertexBuffer(vertices, m_uploadContext);
+    m_vertexBuffer.createIndexBuffer(indices, m_uploadContext);
 }
 
-void Explosion::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
-    // Begin command buffer recording
-    m_commandPool.beginCommandBuffer(commandBuffer, 0);
-
+void Explosion::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex) {
     std::vector<VkClearValue> clearValues(2);
     clearValues[0].color = { {0.9f, 0.9f, 0.9f, 1.0f} };
     clearValues[1].depthStencil = { 1.0f, 0 };
@@ -153,7 +149,7 @@ void Explosion::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imag
         m_pipeline->layout(),
         0,  // First set
         1,  // One set
-        &m_descriptorSets[m_frameManager.currentFrame()],
+        &m_descriptorSets[frameIndex],
         0,
         nullptr
     );
@@ -167,9 +163,21 @@ void Explosion::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imag
 
     // End render pass
     m_pipeline->renderPass().end(commandBuffer);
+}
+
+VkCommandBuffer Explosion::frameCommandBuffer(uint32_t imageIndex) {
+    if (m_prerecordCommands) {
+        return m_prerecordedCommands.get(m_frameManager.currentFrame(), imageIndex,
+            [this](VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t image) {
+                recordCommandBuffer(commandBuffer, frameIndex, image);
+            });
+    }
 
-    // End command buffer recording
-    m_commandPool.endCommandBuffer(commandBuffer);
+    VkCommandBuffer commandBuffer = m_frameManager.allocateCommandBuffer();
+    m_frameManager.currentCommandPool().beginCommandBuffer(commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    recordCommandBuffer(commandBuffer, m_frameManager.currentFrame(), imageIndex);
+    m_frameManager.currentCommandPool().endCommandBuffer(commandBuffer);
+    return commandBuffer;
 }
 
 void Explosion::updateUniformBuffer(uint32_t currentImage)
@@ -233,8 +241,7 @@ void Explosion::drawFrame() {
 
     m_frameManager.resetFence();
 
-    vkResetCommandBuffer(m_commandBuffers[m_frameManager.currentFrame()], 0);
-    recordCommandBuffer(m_commandBuffers[m_frameManager.currentFrame()], imageIndex);
+    VkCommandBuffer commandBuffer = frameCommandBuffer(imageIndex);
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -245,7 +252,7 @@ void Explosion::drawFrame() {
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffers[m_frameManager.currentFrame()];
+    submitInfo.pCommandBuffers = &commandBuffer;
 
     VkSemaphore signalSemaphores[] = { m_frameManager.getCurrentSync().renderFinished() };
     submitInfo.signalSemaphoreCount = 1;
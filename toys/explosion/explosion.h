@@ -11,6 +11,8 @@
 #include "graphics/swap_chain.h"
 #include "graphics/graphics_pipeline.h"
 #include "graphics/command_pool.h"
+#include "graphics/prerecorded_commands.h"
+#include "graphics/upload_context.h"
 #include "resources/buffers/vertex_buffer.h"
 #include "resources/buffers/uniform_buffer.h"
 #include "resources/descriptors/descriptor_set_layout.h"
@@ -31,7 +33,8 @@
 
 class Explosion {
 public:
-    Explosion() = default;
+    // prerecordCommands false records the frame's commands anew every frame
+    explicit Explosion(bool prerecordCommands = true) : m_prerecordCommands(prerecordCommands) {}
     ~Explosion() = default;
 
     void run();
@@ -50,8 +53,8 @@ private:
     void initVulkan();
     void mainLoop();
     void createVertexBuffer();
-    void createCommandBuffers();
-    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex);
+    VkCommandBuffer frameCommandBuffer(uint32_t imageIndex);
     void updateUniformBuffer(uint32_t currentImage);
     void drawFrame();
 
@@ -66,8 +69,7 @@ private:
     vkcommon::MemoryAllocator m_allocator{ m_physicalDevice, m_device };
     vkcommon::SwapChain m_swapChain{ m_window, m_surface, m_physicalDevice, m_device };
 
-    vkcommon::CommandPool m_commandPool{ m_physicalDevice, m_device };
-    std::vector<VkCommandBuffer> m_commandBuffers;
+    vkcommon::UploadContext m_uploadContext{ m_physicalDevice, m_device, m_allocator };
 
     // Pipeline and descriptor
     std::unique_ptr<vkcommon::GraphicsPipeline> m_pipeline;
@@ -84,6 +86,12 @@ private:
     vkcommon::Buffer m_explosionSSBOBuffer{ m_device, m_allocator };
 
     vkcommon::FrameManager m_frameManager{ m_device, MAX_FRAMES_IN_FLIGHT };
+
+    // The explosion is animated through the time in the uniform buffer, the
+    // commands themselves never change and are recorded once per slot and image
+    // Off with --record-every-frame, to compare against recording each frame
+    bool m_prerecordCommands{ true };
+    vkcommon::PrerecordedCommands m_prerecordedCommands{ m_device, m_device.graphicsQueueFamily(), MAX_FRAMES_IN_FLIGHT };
 };
 
 #endif // EXPLOSION_H
@@ -1,31 +1,53 @@
 #include "model_app.h"
 
+#include <iostream>
+
+ModelApp::~ModelApp() {
+    // The set cache outlives the model, whose buffer handles may be reused
+    if (m_model) {
+        m_model->forgetDescriptors(m_descriptorSetCache);
+    }
+}
+
 void ModelApp::run() {
     initVulkan();
     mainLoop();
 }
 
 void ModelApp::initVulkan() {
+    // Before loading, so every texture gets a slot in the table
+    m_bindlessTextures = m_device.supportsBindlessTextures();
+    if (m_bindlessTextures) {
+        m_textureLib.enableBindless();
+    }
+
     createDescriptorSetLayout();
-    createDescriptorPool();
 
     // Load model
     m_model = std::make_unique<vkcommon::Model>(m_device, m_allocator);
     m_model->loadFromFile(
         "D:\\Projects\\Vulkan-Toybox\\toys\\model\\nuka_cup\\nuka_cup.obj",
         m_textureLib,
-        m_commandPool
+        m_uploadContext
     );
 
-    createGlobalDescriptorSets();
+    // Submit all model uploads and keep building the pipeline while they run
+    vkcommon::UploadTicket modelUpload = m_uploadContext.flush();
+
+    createUniformRing();
+    createGlobalDescriptorSet();
     m_model->createDescriptor(
-        m_descriptorPool,
-        *vkcommon::Material::getDescriptorSetLayout(),
-        MAX_FRAMES_IN_FLIGHT);
+        m_descriptorSetCache,
+        vkcommon::Material::getDescriptorSetLayout());
+
+    const vkcommon::DescriptorSetLayout& materialLayout = m_bindlessTextures
+        ? m_textureLib.bindlessTable()->layout()
+        : *vkcommon::Material::getDescriptorSetLayout();
 
     std::vector<VkDescriptorSetLayout> layouts = {
-        m_globalDescriptorSetLayout.handle(),           // set = 0
-        vkcommon::Material::getDescriptorSetLayout()->handle()       // set = 1
+        m_globalDescriptorSetLayout->handle(),           // set = 0
+        materialLayout.handle(),                         // set = 1
+        vkcommon::Model::getDescriptorSetLayout()->handle()          // set = 2
     };
     
     // Create graphics pipeline
@@ -34,8 +56,24 @@ void ModelApp::initVulkan() {
         m_swapChain,
         layouts,
         "shaders/model.vert.spv",
-        "shaders/model.frag.spv"
+        fragmentShaderPath()
     );
+    m_materialPipelines = createMaterialPipelines();
+
+    // Culls with the same global UBO, so both pipelines share set 0
+    m_gpuCulling = m_device.enabledFeatures12().drawIndirectCount;
+    if (m_gpuCulling) {
+        std::vector<VkDescriptorSetLayout> cullLayouts = {
+            m_globalDescriptorSetLayout->handle(),                       // set = 0
+            vkcommon::Model::getCullDescriptorSetLayout()->handle()     // set = 1
+        };
+
+        m_cullPipeline = std::make_unique<vkcommon::ComputePipeline>(
+            m_device,
+            cullLayouts,
+            "shaders/model.comp.spv"
+        );
+    }
 
     // Create color image
     m_colorImage.create(m_swapChain);
@@ -46,16 +84,31 @@ void ModelApp::initVulkan() {
         m_colorImage.imageView(),
         m_depthBuffer.imageView());
 
-    createCommandBuffers();
-}
+    m_uploadContext.wait(modelUpload);
 
-void ModelApp::createCommandBuffers() {
-    m_commandBuffers = m_commandPool.allocateBuffers(MAX_FRAMES_IN_FLIGHT);
 }
 
 void ModelApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
-    // Begin command buffer recording
-    m_commandPool.beginCommandBuffer(commandBuffer, 0);
+    // model and material descriptor sets are bound by the model
+    vkcommon::MaterialPipelineSelector selectPipeline;
+    if (!m_materialPipelines.empty()) {
+        selectPipeline = [this](uint32_t materialIndex) { return m_materialPipelines[materialIndex]; };
+    }
+
+    if (m_gpuCulling) {
+        m_cullPipeline->bind(commandBuffer);
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            m_cullPipeline->layout(),
+            0,
+            1,
+            &m_globalDescriptorSet,
+            1,
+            &m_globalUBOOffset
+        );
+        m_model->recordCulling(commandBuffer, m_cullPipeline->layout(), selectPipeline);
+    }
 
     std::vector<VkClearValue> clearValues(2);
     clearValues[0].color = { {0.9f, 0.9f, 0.9f, 1.0f} };
@@ -80,30 +133,66 @@ void ModelApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t image
         m_pipeline->layout(),
         0,  // First set
         1,  // One set
-        &m_globalDescriptorSets[m_frameManager.currentFrame()],
-        0,
-        nullptr
+        &m_globalDescriptorSet,
+        1,  // Global UBO slice in the uniform ring
+        &m_globalUBOOffset
     );
-    // model descriptor set has been handled fo each mesh in model class (mesh->draw())
-    m_model->draw(commandBuffer, m_frameManager.currentFrame(), m_pipeline->layout());
+    if (m_bindlessTextures) {
+        // Every material's textures in one set, bound once
+        VkDescriptorSet textureTable = m_textureLib.bindlessTable()->descriptorSet();
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            m_pipeline->layout(),
+            1,
+            1,
+            &textureTable,
+            0,
+            nullptr
+        );
+    }
+
+    if (m_gpuCulling) {
+        m_model->drawCulled(commandBuffer, m_pipeline->layout(), m_pipeline->pushConstantStages(), selectPipeline);
+    }
+    else {
+        m_model->draw(commandBuffer, m_pipeline->layout(), m_pipeline->pushConstantStages(), selectPipeline);
+    }
 
     // End render pass
     m_pipeline->renderPass().end(commandBuffer);
+}
+
+VkCommandBuffer ModelApp::frameCommandBuffer(uint32_t imageIndex) {
+    if (m_prerecordCommands) {
+        return m_prerecordedCommands.get(m_frameManager.currentFrame(), imageIndex,
+            [this](VkCommandBuffer commandBuffer, uint32_t, uint32_t image) {
+                recordCommandBuffer(commandBuffer, image);
+            });
+    }
 
-    // End command buffer recording
-    m_commandPool.endCommandBuffer(commandBuffer);
+    VkCommandBuffer commandBuffer = m_frameManager.allocateCommandBuffer();
+    m_frameManager.currentCommandPool().beginCommandBuffer(commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    recordCommandBuffer(commandBuffer, imageIndex);
+    m_frameManager.currentCommandPool().endCommandBuffer(commandBuffer);
+    return commandBuffer;
 }
 
-void ModelApp::updateGlobalUniformBuffer(uint32_t currentImage)
+void ModelApp::updateGlobalUniformBuffer()
 {
     GlobalUniformBufferObject ubo{};
 
     // Model matrix
-    ubo.model = glm::rotate(
+    glm::mat4 transform = glm::rotate(
         glm::mat4(1.0f),
         glm::radians(45.0f),
         glm::vec3(0.0f, 1.0f, 0.0f)
     );
+    if (transform != m_model->transform()) {
+        // Pushed as constants, so part of the recorded commands
+        m_model->setTransform(transform);
+        m_prerecordedCommands.invalidate();
+    }
 
     // View matrix
     ubo.view = glm::lookAt(
@@ -124,14 +213,99 @@ void ModelApp::updateGlobalUniformBuffer(uint32_t currentImage)
     // Vulkan's Y coordinate is inverted compared to OpenGL
     ubo.proj[1][1] *= -1;
 
-    m_globalUBO.updateData(currentImage, &ubo, sizeof(ubo));
+    m_globalUBOOffset = m_uniformRing.push(&ubo, sizeof(ubo));
+
+    if (!m_gpuCulling) {
+        m_model->cull(vkcommon::Frustum::fromMatrix(ubo.proj * ubo.view * m_model->transform()));
+        if (m_model->visibleMeshes() != m_recordedVisibleMeshes) {
+            m_recordedVisibleMeshes = m_model->visibleMeshes();
+            m_prerecordedCommands.invalidate();
+        }
+    }
+}
+
+std::vector<VkPipeline> ModelApp::createMaterialPipelines() {
+    // Materials with the same textures share one variant through the registry
+    std::vector<VkPipeline> materialPipelines;
+    if (m_bindlessTextures) {
+        return materialPipelines;
+    }
+
+    for (const auto& material : m_model->getMaterials()) {
+        if (!material) {
+            materialPipelines.push_back(m_pipeline->handle());
+            continue;
+        }
+
+        vkcommon::PipelineVariant variant{};
+        variant.specialization = material->specialization();
+        materialPipelines.push_back(m_pipeline->variant(m_pipelineRegistry, variant));
+    }
+    return materialPipelines;
+}
+
+const char* ModelApp::fragmentShaderPath() const {
+    return m_bindlessTextures ? "shaders/model_bindless.frag.spv" : "shaders/model.frag.spv";
+}
+
+void ModelApp::reloadChangedShaders() {
+    std::vector<std::filesystem::path> changed = m_shaderWatcher.poll();
+    if (changed.empty()) {
+        return;
+    }
+
+    // Each pipeline keeps drawing with its previous shaders until the next good build
+    try {
+        VkPipeline replaced = m_pipeline->reloadShaders(changed);
+        // Already swapped out, retire it before anything else can throw
+        retirePipeline(replaced);
+        if (replaced != VK_NULL_HANDLE) {
+            m_materialPipelines = createMaterialPipelines();
+            // Only once the new variants exist, a failed build keeps drawing with the old ones
+            for (VkPipeline stale : m_pipeline->evictStaleVariants()) {
+                retirePipeline(stale);
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+
+    if (m_cullPipeline) {
+        try {
+            retirePipeline(m_cullPipeline->reloadShaders(changed));
+        }
+        catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
+    // Drops the modules of the old shaders, unless a pipeline still holds them
+    // for variants that could not be rebuilt yet
+    m_device.shaderLibrary().trim();
+}
+
+void ModelApp::retirePipeline(VkPipeline pipeline) {
+    if (pipeline == VK_NULL_HANDLE) {
+        return;
+    }
+
+    // Prerecorded buffers still bind the old pipeline
+    m_prerecordedCommands.invalidate();
+
+    // Frames still in flight were recorded with the old pipeline
+    m_frameManager.deferDestroy([device = m_device.handle(), pipeline]() {
+        vkDestroyPipeline(device, pipeline, nullptr);
+    });
 }
 
 void ModelApp::drawFrame() {
     m_frameManager.waitForFence();
 
-    updateGlobalUniformBuffer(m_frameManager.currentFrame());
-    m_model->updateProperties(m_frameManager.currentFrame());
+    // This frame's fence has signaled, so its ring region is free to overwrite
+    m_uniformRing.beginFrame(m_frameManager.currentFrame());
+    reloadChangedShaders();
+    updateGlobalUniformBuffer();
 
     uint32_t imageIndex;
     VkResult result = vkAcquireNextImageKHR(
@@ -149,8 +323,7 @@ void ModelApp::drawFrame() {
 
     m_frameManager.resetFence();
 
-    vkResetCommandBuffer(m_commandBuffers[m_frameManager.currentFrame()], 0);
-    recordCommandBuffer(m_commandBuffers[m_frameManager.currentFrame()], imageIndex);
+    VkCommandBuffer commandBuffer = frameCommandBuffer(imageIndex);
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -161,7 +334,7 @@ void ModelApp::drawFrame() {
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffers[m_frameManager.currentFrame()];
+    submitInfo.pCommandBuffers = &commandBuffer;
 
     VkSemaphore signalSemaphores[] = { m_frameManager.getCurrentSync().renderFinished() };
     submitInfo.signalSemaphoreCount = 1;
@@ -195,57 +368,50 @@ void ModelApp::mainLoop() {
         drawFrame();
     }
     
-    // destroy the static material descriptor layout
+    // destroy the static material and model descriptor layouts
     vkcommon::Material::destroyDescriptorSetLayout();
+    vkcommon::Model::destroyDescriptorSetLayout();
     vkDeviceWaitIdle(m_device.handle());
 }
 
 void ModelApp::createDescriptorSetLayout()
 {
-    m_globalDescriptorSetLayout.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);
-    m_globalDescriptorSetLayout.create();
-
-    vkcommon::Material::createDescriptorSetLayout(m_device);
+    m_globalDescriptorSetLayout = &m_device.descriptorSetLayoutCache().get({
+        vkcommon::DescriptorSetLayoutCache::binding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT)
+    });
+
+    // Sets 1 and 2 follow the shaders; set 0 is dynamic and shared with culling
+    vkcommon::ShaderReflection reflection = vkcommon::ShaderReflection::fromFile("shaders/model.vert.spv");
+    reflection.merge(vkcommon::ShaderReflection::fromFile(fragmentShaderPath()));
+
+    // With bindless textures set 1 is the TextureLibrary's table
+    if (!m_bindlessTextures) {
+        vkcommon::Material::createDescriptorSetLayout(m_device, reflection);
+    }
+    vkcommon::Model::createDescriptorSetLayout(m_device, reflection);
 
 }
 
-void ModelApp::createDescriptorPool()
+void ModelApp::createUniformRing()
 {
-    const uint32_t maxMaterials = 100;  // Adjust based on your needs
-    const uint32_t maxTextures = maxMaterials * 3;  // Assume up to 3 textures per material
-    
-    // global uniform buffer
-    m_descriptorPool.addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT);
-    // material properties
-    m_descriptorPool.addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT * maxMaterials);
-    // material textures
-    m_descriptorPool.addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_FRAMES_IN_FLIGHT * maxTextures);
-    m_descriptorPool.create(MAX_FRAMES_IN_FLIGHT * (1 + maxMaterials));
+    // One global UBO each frame, material properties are static in the model
+    VkDeviceSize frameSize = m_uniformRing.alignedSize(sizeof(GlobalUniformBufferObject));
+
+    m_uniformRing.create(frameSize, MAX_FRAMES_IN_FLIGHT);
 }
 
-void ModelApp::createGlobalDescriptorSets()
+void ModelApp::createGlobalDescriptorSet()
 {
     // model's descriptor has been handled in model class
 
-    m_globalUBO.create(sizeof(GlobalUniformBufferObject), MAX_FRAMES_IN_FLIGHT);
-
-    m_globalDescriptorSets = m_descriptorPool.allocate(m_globalDescriptorSetLayout.handle(), MAX_FRAMES_IN_FLIGHT);
-
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        vkcommon::DescriptorWriter descriptorWriter{ m_globalDescriptorSets[i] };
-        descriptorWriter.writeBuffer(
-            0,
-            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            m_globalUBO.buffer(i),
-            sizeof(GlobalUniformBufferObject)
-        );
-
-        descriptorWriter.update(m_device);
-    }
-
-}
-
-void ModelApp::createModelDescriptorSets()
-{
+    vkcommon::DescriptorWriter descriptorWriter;
+    descriptorWriter.writeBuffer(
+        0,
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+        m_uniformRing.buffer(),
+        sizeof(GlobalUniformBufferObject)
+    );
 
+    m_globalDescriptorSet = m_descriptorSetCache.get(*m_globalDescriptorSetLayout, descriptorWriter);
 }
@@ -10,12 +10,22 @@
 #include "core/device.h"
 #include "graphics/swap_chain.h"
 #include "graphics/graphics_pipeline.h"
+#include "graphics/compute_pipeline.h"
+#include "graphics/pipeline_registry.h"
+#include "graphics/shader_library.h"
+#include "graphics/shader_reflection.h"
+#include "graphics/shader_watcher.h"
 #include "graphics/command_pool.h"
+#include "graphics/prerecorded_commands.h"
+#include "graphics/upload_context.h"
 #include "resources/buffers/vertex_buffer.h"
-#include "resources/buffers/uniform_buffer.h"
+#include "resources/buffers/uniform_ring.h"
 #include "resources/descriptors/descriptor_set_layout.h"
-#include "resources/descriptors/descriptor_pool.h"
+#include "resources/descriptors/descriptor_allocator.h"
+#include "resources/descriptors/descriptor_set_cache.h"
+#include "resources/descriptors/descriptor_set_layout_cache.h"
 #include "resources/descriptors/descriptor_writer.h"
+#include "resources/descriptors/bindless_texture_table.h"
 #include "resources/images/color_image.h"
 #include "resources/images/depth_buffer.h"
 #include "resources/memory/memory_allocator.h"
@@ -23,6 +33,7 @@
 #include "resources/model/texture_lib.h"
 #include "resources/model/model.h"
 #include "resources/model/material.h"
+#include "resources/model/frustum.h"
 #include "sync/frame_manager.h"
 
 #define GLM_FORCE_RADIANS
@@ -34,17 +45,18 @@
 
 class ModelApp {
 public:
-    ModelApp() = default;
-    ~ModelApp() = default;
+    // prerecordCommands false records the frame's commands anew every frame
+    explicit ModelApp(bool prerecordCommands = true) : m_prerecordCommands(prerecordCommands) {}
+    ~ModelApp();
 
     void run();
 
 private:
     static const int MAX_FRAMES_IN_FLIGHT = 2;
 
+    // The model matrix is pushed per model, see Model::DrawConstants
     struct GlobalUniformBufferObject
     {
-        alignas(16) glm::mat4 model;
         alignas(16) glm::mat4 view;
         alignas(16) glm::mat4 proj;
     };
@@ -54,13 +66,17 @@ private:
     void drawFrame();
 
     void createDescriptorSetLayout();
-    void createDescriptorPool();
-    void createGlobalDescriptorSets();
-    void createModelDescriptorSets();
+    void createUniformRing();
+    void createGlobalDescriptorSet();
 
-    void createCommandBuffers();
     void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
-    void updateGlobalUniformBuffer(uint32_t currentImage);
+    VkCommandBuffer frameCommandBuffer(uint32_t imageIndex);
+    void updateGlobalUniformBuffer();
+    // Built aside, so a failure leaves m_materialPipelines untouched
+    std::vector<VkPipeline> createMaterialPipelines();
+    const char* fragmentShaderPath() const;
+    void reloadChangedShaders();
+    void retirePipeline(VkPipeline pipeline);
 
     // Core Vulkan Objects
     vkcommon::Window m_window;
@@ -71,24 +87,52 @@ private:
     vkcommon::MemoryAllocator m_allocator{ m_physicalDevice, m_device };
     vkcommon::SwapChain m_swapChain{ m_window, m_surface, m_physicalDevice, m_device };
 
-    vkcommon::CommandPool m_commandPool{ m_physicalDevice, m_device };
-    std::vector<VkCommandBuffer> m_commandBuffers;
+    vkcommon::UploadContext m_uploadContext{ m_physicalDevice, m_device, m_allocator };
 
     vkcommon::TextureLibrary m_textureLib{ m_device, m_allocator };
 
     // Pipeline and descriptor
+    // Declared before the pipeline, which releases its variants on destruction
+    vkcommon::PipelineRegistry m_pipelineRegistry{ m_device };
     std::unique_ptr<vkcommon::GraphicsPipeline> m_pipeline;
-    std::vector<VkDescriptorSet> m_globalDescriptorSets;
-    vkcommon::DescriptorSetLayout m_globalDescriptorSetLayout{ m_device };
-    vkcommon::DescriptorPool m_descriptorPool{ m_device };
+    // Per material, specialized on the textures it has. Empty with bindless
+    // textures, where one pipeline draws every material.
+    std::vector<VkPipeline> m_materialPipelines;
+    // Textures through the TextureLibrary's table (set = 1) instead of a set per material
+    bool m_bindlessTextures{ false };
+    // Frustum culling on the GPU when drawIndirectCount is available, else on the CPU
+    std::unique_ptr<vkcommon::ComputePipeline> m_cullPipeline;
+    bool m_gpuCulling{ false };
+    VkDescriptorSet m_globalDescriptorSet{ VK_NULL_HANDLE };
+    // Owned by the device's layout cache
+    const vkcommon::DescriptorSetLayout* m_globalDescriptorSetLayout{ nullptr };
+    // Grows with the number of materials, nothing is sized up front
+    vkcommon::DescriptorAllocator m_descriptorAllocator{ m_device };
+    // Materials sharing textures share one set, written once
+    vkcommon::DescriptorSetCache m_descriptorSetCache{ m_device, m_descriptorAllocator };
 
     // Resources
     vkcommon::ColorImage m_colorImage{ m_device, m_allocator };
     vkcommon::DepthBuffer m_depthBuffer{ m_device, m_allocator };
-    vkcommon::UniformBuffer m_globalUBO{ m_device, m_allocator };
+    vkcommon::UniformRing m_uniformRing{ m_device, m_allocator };
+    uint32_t m_globalUBOOffset{ 0 };
     std::unique_ptr<vkcommon::Model> m_model;
 
     vkcommon::FrameManager m_frameManager{ m_device, MAX_FRAMES_IN_FLIGHT };
+
+    // The model only moves through the global UBO, so commands are recorded
+    // once per frame slot and swapchain image. Its dynamic offset is the
+    // start of the slot's ring region every frame, so it stays valid too.
+    // Invalidated when a pipeline, the model transform or the CPU culling
+    // result changes.
+    // Off with --record-every-frame, to compare against recording each frame
+    bool m_prerecordCommands{ true };
+    vkcommon::PrerecordedCommands m_prerecordedCommands{ m_device, m_device.graphicsQueueFamily(), MAX_FRAMES_IN_FLIGHT };
+    // Meshes the prerecorded draws were recorded with
+    std::vector<uint32_t> m_recordedVisibleMeshes;
+
+    // Rebuilding the shader targets swaps the affected pipelines between frames
+    vkcommon::ShaderWatcher m_shaderWatcher{ "shaders" };
 };
 
 #endif // MODEL_APP_H
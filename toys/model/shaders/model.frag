@@ -3,8 +3,9 @@
 layout(location = 0) in vec3 fragPos;
 layout(location = 1) in vec2 fragTexCoord;
 layout(location = 2) in mat3 TBN;
+layout(location = 5) flat in uint fragMaterialIndex;
 
-layout(set = 1, binding = 0) uniform MaterialUBO {
+struct Material {
     vec4 ambientColor;
     vec4 diffuseColor;
     vec4 specularColor;
@@ -12,23 +13,43 @@ layout(set = 1, binding = 0) uniform MaterialUBO {
     float shininess;
     float opacity;
     float refractiveIndex;
-} material;
+    uint diffuseTexture;        // Bindless slots, unused here
+    uint specularTexture;
+    uint normalTexture;
+};
 
-layout(set = 1, binding = 1) uniform sampler2D diffuseMap;
-layout(set = 1, binding = 2) uniform sampler2D specularMap;
-layout(set = 1, binding = 3) uniform sampler2D normalMap;
+// Material::specialization() turns off the textures a material lacks
+layout(constant_id = 0) const bool HAS_DIFFUSE_MAP = true;
+layout(constant_id = 1) const bool HAS_SPECULAR_MAP = true;
+layout(constant_id = 2) const bool HAS_NORMAL_MAP = true;
+
+layout(set = 1, binding = 0) uniform sampler2D diffuseMap;
+layout(set = 1, binding = 1) uniform sampler2D specularMap;
+layout(set = 1, binding = 2) uniform sampler2D normalMap;
+
+layout(std430, set = 2, binding = 0) readonly buffer MaterialBuffer {
+    Material materials[];
+};
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
+    Material material = materials[fragMaterialIndex];
+
     vec3 lightDir = normalize(vec3(1.0, 1.0, 1.0));
     vec3 viewDir = normalize(vec3(1.0, 1.0, -1.0) - fragPos);
 
-    vec4 diffuseTexColor = texture(diffuseMap, fragTexCoord);
-    vec4 specularTexColor = texture(specularMap, fragTexCoord);
+    vec4 diffuseTexColor = HAS_DIFFUSE_MAP ? texture(diffuseMap, fragTexCoord) : vec4(1.0);
+    vec4 specularTexColor = HAS_SPECULAR_MAP ? texture(specularMap, fragTexCoord) : vec4(1.0);
 
-    vec3 normalMapColor = texture(normalMap, fragTexCoord).rgb;
-    vec3 normal = normalize(TBN * (normalMapColor * 2.0 - 1.0));
+    vec3 normal;
+    if (HAS_NORMAL_MAP) {
+        vec3 normalMapColor = texture(normalMap, fragTexCoord).rgb;
+        normal = normalize(TBN * (normalMapColor * 2.0 - 1.0));
+    }
+    else {
+        normal = normalize(TBN[2]);
+    }
 
     vec3 ambient = material.ambientColor.rgb;
 
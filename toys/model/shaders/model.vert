@@ -1,11 +1,16 @@
 #version 450
 
 layout(set = 0, binding = 0) uniform UniformBufferObject {
-    mat4 model;
     mat4 view;
     mat4 proj;  
 } ubo;
 
+// Matches Model::DrawConstants
+layout(push_constant) uniform DrawConstants {
+    mat4 model;
+    mat4 normalMatrix;
+} draw;
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord;
@@ -15,14 +20,17 @@ layout(location = 4) in vec3 inBitangent;
 layout(location = 0) out vec3 fragPos;
 layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out mat3 TBN;
+// Material index, passed as firstInstance by the draw
+layout(location = 5) flat out uint fragMaterialIndex;
 
 void main() {
-    vec4 worldPos = ubo.model * vec4(inPosition, 1.0);
+    vec4 worldPos = draw.model * vec4(inPosition, 1.0);
     gl_Position = ubo.proj * ubo.view * worldPos;
     fragPos = worldPos.xyz;
     fragTexCoord = inTexCoord;
+    fragMaterialIndex = gl_InstanceIndex;
 
-    mat3 normalMatrix = transpose(inverse(mat3(ubo.model)));
+    mat3 normalMatrix = mat3(draw.normalMatrix);
     vec3 T = normalize(normalMatrix * inTangent);
     vec3 B = normalize(normalMatrix * inBitangent);
     vec3 N = normalize(normalMatrix * inNormal);
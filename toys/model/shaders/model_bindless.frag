@@ -0,0 +1,70 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 fragPos;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) in mat3 TBN;
+layout(location = 5) flat in uint fragMaterialIndex;
+
+struct Material {
+    vec4 ambientColor;
+    vec4 diffuseColor;
+    vec4 specularColor;
+    vec4 emissiveColor;
+    float shininess;
+    float opacity;
+    float refractiveIndex;
+    uint diffuseTexture;        // Slots in the texture table, NO_TEXTURE when absent
+    uint specularTexture;
+    uint normalTexture;
+};
+
+// Matches BindlessTextureTable::kNoTexture
+const uint NO_TEXTURE = 0xFFFFFFFFu;
+
+// TextureLibrary's bindless table, bound once for every material
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(std430, set = 2, binding = 0) readonly buffer MaterialBuffer {
+    Material materials[];
+};
+
+layout(location = 0) out vec4 outColor;
+
+// Draws of one indirect call may use different materials, hence nonuniformEXT
+vec4 sampleTexture(uint slot, vec4 fallback) {
+    return slot == NO_TEXTURE ? fallback : texture(textures[nonuniformEXT(slot)], fragTexCoord);
+}
+
+void main() {
+    Material material = materials[fragMaterialIndex];
+
+    vec3 lightDir = normalize(vec3(1.0, 1.0, 1.0));
+    vec3 viewDir = normalize(vec3(1.0, 1.0, -1.0) - fragPos);
+
+    vec4 diffuseTexColor = sampleTexture(material.diffuseTexture, vec4(1.0));
+    vec4 specularTexColor = sampleTexture(material.specularTexture, vec4(1.0));
+
+    vec3 normal;
+    if (material.normalTexture != NO_TEXTURE) {
+        vec3 normalMapColor = sampleTexture(material.normalTexture, vec4(0.5, 0.5, 1.0, 1.0)).rgb;
+        normal = normalize(TBN * (normalMapColor * 2.0 - 1.0));
+    }
+    else {
+        normal = normalize(TBN[2]);
+    }
+
+    vec3 ambient = material.ambientColor.rgb;
+
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = diff * material.diffuseColor.rgb * diffuseTexColor.rgb;
+
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    vec3 specular = spec * material.specularColor.rgb * specularTexColor.rgb;
+
+    vec3 result = ambient + diffuse + specular + material.emissiveColor.rgb;
+
+    float alpha = diffuseTexColor.a * material.opacity;
+    outColor = vec4(result, alpha);
+}
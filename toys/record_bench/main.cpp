@@ -0,0 +1,174 @@
+// Benchmark of ParallelRecorder: CPU time to record one render pass of tens
+// of thousands of small draws into secondary command buffers, for 1 thread
+// up to every hardware thread. Each draw binds nothing but its own push
+// constants, so the time is dominated by command recording. The recorded
+// frames are never submitted; the window only exists for the surface the
+// device is picked with.
+
+#include "core/window.h"
+#include "core/instance.h"
+#include "core/surface.h"
+#include "core/physical_device.h"
+#include "core/device.h"
+#include "graphics/swap_chain.h"
+#include "graphics/graphics_pipeline.h"
+#include "graphics/command_pool.h"
+#include "graphics/parallel_recorder.h"
+#include "graphics/upload_context.h"
+#include "resources/buffers/vertex_buffer.h"
+#include "resources/images/color_image.h"
+#include "resources/images/depth_buffer.h"
+#include "resources/memory/memory_allocator.h"
+
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Matches the push_constant block of record_bench.vert
+    struct DrawConstants {
+        glm::vec4 offsetScale;
+        glm::vec4 color;
+    };
+
+    constexpr uint32_t kDrawCount = 50'000;
+    constexpr uint32_t kGridSize = 224;     // kGridSize^2 >= kDrawCount
+
+    class RecordBench {
+    public:
+        RecordBench() {
+            m_pipeline = std::make_unique<vkcommon::GraphicsPipeline>(
+                m_device,
+                m_swapChain,
+                std::vector<VkDescriptorSetLayout>{},
+                "shaders/record_bench.vert.spv",
+                "shaders/record_bench.frag.spv"
+            );
+
+            m_colorImage.create(m_swapChain);
+            m_depthBuffer.create(m_swapChain);
+            m_swapChain.createFrameBuffers(
+                m_pipeline->renderPass(),
+                m_colorImage.imageView(),
+                m_depthBuffer.imageView());
+
+            // Only the position is read by the shader
+            std::vector<vkcommon::Vertex> vertices(3, vkcommon::Vertex{});
+            vertices[0].pos = { -1.0f, -1.0f, 0.0f };
+            vertices[1].pos = {  1.0f, -1.0f, 0.0f };
+            vertices[2].pos = {  0.0f,  1.0f, 0.0f };
+            m_triangle.createVertexBuffer(vertices, m_uploadContext);
+            m_uploadContext.waitIdle();
+
+            for (uint32_t i = 0; i < kDrawCount; i++) {
+                float x = (static_cast<float>(i % kGridSize) + 0.5f) / kGridSize * 2.0f - 1.0f;
+                float y = (static_cast<float>(i / kGridSize) + 0.5f) / kGridSize * 2.0f - 1.0f;
+                float shade = static_cast<float>(i) / kDrawCount;
+                m_draws.push_back({ glm::vec4(x, y, 0.4f / kGridSize, 0.0f), glm::vec4(shade, 1.0f - shade, 0.5f, 1.0f) });
+            }
+        }
+
+        // Best of several frames, in milliseconds
+        double recordMilliseconds(uint32_t threadCount) {
+            using Clock = std::chrono::steady_clock;
+
+            vkcommon::ParallelRecorder recorder(m_device, m_device.graphicsQueueFamily(), 1, threadCount);
+            VkCommandBuffer primary = m_commandPool.allocateSingleBuffer();
+            VkFramebuffer framebuffer = m_swapChain.swapChainFramebuffer(0);
+            const vkcommon::RenderPass& renderPass = m_pipeline->renderPass();
+
+            auto recordRange = [this](VkCommandBuffer commandBuffer, uint32_t first, uint32_t count) {
+                m_pipeline->bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                m_pipeline->setViewportState(commandBuffer, m_swapChain.swapChainExtent());
+
+                VkBuffer vertexBuffer = m_triangle.vertexBuffer();
+                VkDeviceSize offset = 0;
+                vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+
+                for (uint32_t i = first; i < first + count; i++) {
+                    m_pipeline->pushConstants(commandBuffer, m_draws[i]);
+                    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+                }
+            };
+
+            std::vector<VkClearValue> clearValues(2);
+            clearValues[0].color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+            clearValues[1].depthStencil = { 1.0f, 0 };
+
+            double best = 0.0;
+            for (int run = 0; run < 10; run++) {
+                auto start = Clock::now();
+
+                // Nothing was submitted, so the pools can be reset right away
+                recorder.beginFrame(0);
+                m_commandPool.beginCommandBuffer(primary, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+                renderPass.begin(primary, framebuffer, m_swapChain.swapChainExtent(), clearValues,
+                    VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+                recorder.execute(primary, kDrawCount, renderPass, 0, framebuffer, recordRange);
+                renderPass.end(primary);
+                m_commandPool.endCommandBuffer(primary);
+
+                std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+                best = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+            }
+
+            m_commandPool.freeSingleBuffer(primary);
+            return best;
+        }
+
+    private:
+        vkcommon::Window m_window;
+        vkcommon::Instance m_instance;
+        vkcommon::Surface m_surface{ m_instance, m_window };
+        vkcommon::PhysicalDevice m_physicalDevice{ m_instance, m_surface };
+        vkcommon::Device m_device{ m_physicalDevice };
+        vkcommon::MemoryAllocator m_allocator{ m_physicalDevice, m_device };
+        vkcommon::SwapChain m_swapChain{ m_window, m_surface, m_physicalDevice, m_device };
+
+        vkcommon::CommandPool m_commandPool{ m_physicalDevice, m_device };
+        vkcommon::UploadContext m_uploadContext{ m_physicalDevice, m_device, m_allocator };
+
+        std::unique_ptr<vkcommon::GraphicsPipeline> m_pipeline;
+        vkcommon::ColorImage m_colorImage{ m_device, m_allocator };
+        vkcommon::DepthBuffer m_depthBuffer{ m_device, m_allocator };
+        vkcommon::VertexBuffer m_triangle{ m_device, m_allocator };
+        std::vector<DrawConstants> m_draws;
+    };
+}
+
+int main() {
+    try {
+        RecordBench bench;
+
+        std::printf("%u draws per frame\n", kDrawCount);
+        std::printf("%8s %12s %10s\n", "threads", "record ms", "speedup");
+
+        uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        double single = 0.0;
+        for (uint32_t threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+            double ms = bench.recordMilliseconds(threads);
+            if (threads == 1) {
+                single = ms;
+            }
+            std::printf("%8u %12.3f %9.2fx\n", threads, ms, single / ms);
+
+            if (threads == maxThreads) {
+                break;
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
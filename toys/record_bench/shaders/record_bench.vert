@@ -0,0 +1,16 @@
+#version 450
+
+// One per draw, see DrawConstants in main.cpp
+layout(push_constant) uniform DrawConstants {
+    vec4 offsetScale;   // xy offset, z scale
+    vec4 color;
+} draw;
+
+layout(location = 0) in vec3 inPosition;
+
+layout(location = 0) out vec4 fragColor;
+
+void main() {
+    gl_Position = vec4(inPosition.xy * draw.offsetScale.z + draw.offsetScale.xy, 0.5, 1.0);
+    fragColor = draw.color;
+}
@@ -24,7 +24,10 @@ void TriangleApp::initVulkan() {
 
     m_swapChain.createFrameBuffers(m_pipeline->renderPass(), m_colorImage.imageView(), m_depthBuffer.imageView());
     createVertexBuffer();
-    createCommandBuffers();
+
+    // Wait for the vertex upload before the first frame
+    m_uploadContext.waitIdle();
+
 }
 
 void TriangleApp::createVertexBuffer() {
@@ -34,16 +37,12 @@ void TriangleApp::createVertexBuffer() {
         {{0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}}
     };
 
-    m_vertexBuffer.createVertexBuffer(vertices, m_commandPool);
-}
-
-void TriangleApp::createCommandBuffers() {
-    m_commandBuffers = m_commandPool.allocateBuffers(MAX_FRAMES_IN_FLIGHT);
+    m_vertexBuffer.createVertexBuffer(vertices, m_uploadContext);
 }
 
 void TriangleApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
     // Begin command buffer recording
-    m_commandPool.beginCommandBuffer(commandBuffer, 0);
+    m_frameManager.currentCommandPool().beginCommandBuffer(commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
     std::vector<VkClearValue> clearValues(2);
     clearValues[0].color = { {1.0f, 1.0f, 1.0f, 1.0f} };
@@ -72,7 +71,7 @@ void TriangleApp::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t im
     m_pipeline->renderPass().end(commandBuffer);
 
     // End command buffer recording
-    m_commandPool.endCommandBuffer(commandBuffer);
+    m_frameManager.currentCommandPool().endCommandBuffer(commandBuffer);
 }
 
 void TriangleApp::drawFrame() {
@@ -94,8 +93,8 @@ void TriangleApp::drawFrame() {
 
     m_frameManager.resetFence();
 
-    vkResetCommandBuffer(m_commandBuffers[m_frameManager.currentFrame()], 0);
-    recordCommandBuffer(m_commandBuffers[m_frameManager.currentFrame()], imageIndex);
+    VkCommandBuffer commandBuffer = m_frameManager.allocateCommandBuffer();
+    recordCommandBuffer(commandBuffer, imageIndex);
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -106,7 +105,7 @@ void TriangleApp::drawFrame() {
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffers[m_frameManager.currentFrame()];
+    submitInfo.pCommandBuffers = &commandBuffer;
 
     VkSemaphore signalSemaphores[] = { m_frameManager.getCurrentSync().renderFinished() };
     submitInfo.signalSemaphoreCount = 1;
@@ -11,6 +11,7 @@
 #include "graphics/swap_chain.h"
 #include "graphics/graphics_pipeline.h"
 #include "graphics/command_pool.h"
+#include "graphics/upload_context.h"
 #include "resources/buffers/vertex_buffer.h"
 #include "resources/memory/memory_allocator.h"
 #include "sync/frame_manager.h"
@@ -34,7 +35,6 @@ private:
     void initVulkan();
     void mainLoop();
     void createVertexBuffer();
-    void createCommandBuffers();
     void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
     void drawFrame();
 
@@ -47,8 +47,7 @@ private:
     vkcommon::SwapChain m_swapChain{ m_window, m_surface, m_physicalDevice, m_device };
     vkcommon::DescriptorSetLayout m_descriptorSetLayout{ m_device };
     std::unique_ptr<vkcommon::GraphicsPipeline> m_pipeline;
-    vkcommon::CommandPool m_commandPool{ m_physicalDevice, m_device };
-    std::vector<VkCommandBuffer> m_commandBuffers;
+    vkcommon::UploadContext m_uploadContext{ m_physicalDevice, m_device, m_allocator };
     vkcommon::VertexBuffer m_vertexBuffer{ m_device, m_allocator };
 
     vkcommon::ColorImage m_colorImage{ m_device, m_allocator };